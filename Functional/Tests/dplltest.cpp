@@ -1,5 +1,5 @@
 #include "../include/dpll/dpllsolver.h"
-#include "../include/parser/DIMACSParser.h"
+#include "../include/general/formula.h"
 #include <iostream>
 #include <vector>
 #include <fstream>
@@ -40,10 +40,12 @@ bool verifySolution(const vector<int>& assignment, const vector<vector<int>>& or
     return true;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // Files given on the command line replace the built-in list
     vector<string> testFiles = {
         "C:\\Users\\Lenovo\\CLionProjects\\MPI_SAT_Unified\\Functional\\DIMACS\\extra\\ex.cnf",
     };
+    if (argc > 1) testFiles.assign(argv + 1, argv + argc);
 
 
     // Open results file in append mode
@@ -65,14 +67,14 @@ int main() {
 
             auto start = chrono::high_resolution_clock::now();
 
-            DPLLSolver solver(filename);
-            DIMACSParser parser(filename);
-            auto originalClauses = parser.getClauses();
+            auto formula = Formula::load(filename);
+            DPLLSolver solver(formula);
+            auto originalClauses = formula->getClauses();
 
             cout << "Parser initialized successfully" << endl;
             cout << "Formula statistics:" << endl;
-            cout << "Variables: " << parser.getNumLiterals() << endl;
-            cout << "Clauses: " << parser.getNumClauses() << endl;
+            cout << "Variables: " << formula->getNumLiterals() << endl;
+            cout << "Clauses: " << formula->getNumClauses() << endl;
 
             bool result = solver.solve();
             auto assignment = solver.getAssignment();
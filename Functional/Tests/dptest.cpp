@@ -20,10 +20,12 @@ string getFileNameFromPath(const string& path) {
     return path;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // Files given on the command line replace the built-in list
     vector<string> testFiles = {
         "C:\\Users\\Lenovo\\CLionProjects\\MPI_SAT_Unified\\Functional\\DIMACS\\extra\\ex.cnf",
     };
+    if (argc > 1) testFiles.assign(argv + 1, argv + argc);
     vector<string> testFiles2 = {
         "C:\\Users\\Lenovo\\CLionProjects\\MPI_SAT_Unified\\Functional\\DIMACS\\extra\\twsat.cnf",
     };
@@ -0,0 +1,49 @@
+#include "../include/dpll/paralleldpll.h"
+#include "../include/general/formula.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+
+using namespace std;
+
+// Small formulas whose answer is known, run on several thread counts;
+// a SAT answer must come with a model of every clause
+int main() {
+    struct Case {
+        string name;
+        int numVars;
+        vector<int> literals;  // clauses ended by 0
+        SolveResult expected;
+    };
+    vector<Case> cases = {
+        {"single tautology", 2, {1, -1, 2, 0}, SolveResult::Sat},
+        {"tautology beside a unit", 3, {1, -1, 0, 3, 0, -2, 2, 3, 0}, SolveResult::Sat},
+        {"tautology with repeated literals", 2, {2, 2, -2, 0, 1, 0}, SolveResult::Sat},
+        {"tautology in an unsatisfiable formula", 2, {1, -1, 0, 2, 0, -2, 0}, SolveResult::Unsat},
+        {"all four clauses over two variables", 2, {1, 2, 0, 1, -2, 0, -1, 2, 0, -1, -2, 0}, SolveResult::Unsat},
+        {"branchy satisfiable", 4, {1, 2, 0, -1, 3, 0, -2, -3, 0, 3, 4, -4, 0, -1, -4, 0}, SolveResult::Sat},
+    };
+
+    int failures = 0;
+    for (const Case& test : cases) {
+        int numClauses = 0;
+        for (int lit : test.literals) numClauses += lit == 0;
+        auto formula = make_shared<const Formula>(test.numVars, numClauses, test.literals);
+
+        for (unsigned threads : {1u, 2u, 4u}) {
+            ParallelDPLLResult result = runParallelDPLL(formula, threads);
+            bool ok = result.status == test.expected &&
+                      (result.status != SolveResult::Sat || formula->isModel(result.model));
+            cout << test.name << ", " << threads << " threads: "
+                 << (result.status == SolveResult::Sat     ? "SAT"
+                     : result.status == SolveResult::Unsat ? "UNSAT"
+                                                           : "UNKNOWN")
+                 << (ok ? "" : "  FAILED") << endl;
+            if (!ok) failures++;
+        }
+    }
+
+    cout << (failures == 0 ? "All parallel DPLL checks passed" : "Some parallel DPLL checks failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
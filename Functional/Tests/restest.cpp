@@ -8,9 +8,10 @@
 #include <iomanip> // Include for setting precision
 using namespace std;
 
-int main() {
-    // Specify the path to a DIMACS CNF file
+int main(int argc, char** argv) {
+    // Specify the path to a DIMACS CNF file (or pass it as the argument)
     string filename = "C:\\Users\\Lenovo\\CLionProjects\\MPI_SAT_Unified\\Functional\\DIMACS\\extra\\ex.cnf";
+    if (argc > 1) filename = argv[1];
 
 
 
@@ -34,7 +35,9 @@ int main() {
     cout << "Execution time: " << duration<< endl;
 
     // Output the result
-    if (result) {
+    if (solver.wasInterrupted()) {
+        cout << "The solver gave up before finding an answer." << endl;
+    } else if (result) {
         cout << "The formula is SATISFIABLE." << endl;
     } else {
         cout << "The formula is UNSATISFIABLE." << endl;
@@ -0,0 +1,70 @@
+#include "../include/general/formula.h"
+#include "../include/parser/snapshot.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstddef>
+#include <stdexcept>
+#include <functional>
+
+using namespace std;
+
+// Writes formula as a snapshot, lets damage() change the header, and
+// reports whether Formula::load() still accepted the file
+bool loadsAfter(const Formula& formula, const string& filename, const function<void(SnapshotHeader&)>& damage) {
+    formula.saveSnapshot(filename);
+
+    SnapshotHeader header{};
+    fstream file(filename, ios::in | ios::out | ios::binary);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    damage(header);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+
+    try {
+        Formula::load(filename);
+        return true;
+    } catch (const runtime_error& e) {
+        cout << "Rejected: " << e.what() << endl;
+        return false;
+    }
+}
+
+int main(int argc, char** argv) {
+    string filename = argc > 1 ? argv[1] : "snapshottest.snap";
+
+    // (1 v -2) (2 v 3) (-1 v -3), 3 variables
+    Formula formula(3, 3, {1, -2, 0, 2, 3, 0, -1, -3, 0});
+
+    struct Case {
+        string name;
+        bool loads;
+        function<void(SnapshotHeader&)> damage;
+    };
+    vector<Case> cases = {
+        {"intact header", true, [](SnapshotHeader&) {}},
+        {"numVars below the highest variable", false, [](SnapshotHeader& h) { h.numVars = 1; }},
+        {"numVars above the highest variable", false, [](SnapshotHeader& h) { h.numVars = 1000; }},
+        {"negative numLiterals", false, [](SnapshotHeader& h) { h.numLiterals = -1; }},
+        {"parsedClauses too small", false, [](SnapshotHeader& h) { h.parsedClauses = 1; }},
+        {"parsedClauses too large", false, [](SnapshotHeader& h) { h.parsedClauses = 4; }},
+        {"hash of other clauses", false, [](SnapshotHeader& h) { h.hash ^= 1; }},
+    };
+
+    int failures = 0;
+    for (const Case& test : cases) {
+        cout << "Snapshot with " << test.name << endl;
+        bool loads = loadsAfter(formula, filename, test.damage);
+        if (loads != test.loads) {
+            cout << "FAILED: expected the snapshot to be " << (test.loads ? "accepted" : "rejected") << endl;
+            failures++;
+        }
+    }
+    remove(filename.c_str());
+
+    cout << (failures == 0 ? "All snapshot checks passed" : "Some snapshot checks failed") << endl;
+    return failures == 0 ? 0 : 1;
+}
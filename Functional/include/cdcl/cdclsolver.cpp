@@ -0,0 +1,442 @@
+#include "./cdclsolver.h"
+#include <iostream>
+#include <algorithm>
+#include "../general/log.h"
+using namespace std;
+
+CDCLSolver::CDCLSolver() : CDCLSolver(make_shared<const Formula>(0, 0, vector<int>())) {}
+
+CDCLSolver::CDCLSolver(const string& filename) : CDCLSolver(Formula::load(filename)) {}
+
+CDCLSolver::CDCLSolver(shared_ptr<const Formula> formula) : SATSolver(move(formula)) {
+    setRestartStrategy(RestartStrategy::Glucose);
+}
+
+bool CDCLSolver::solve() {
+    cout << "Solving using CDCL..." << endl;
+
+    SolveResult outcome = solve(vector<int>());
+
+    satlog::flush();
+    if (outcome == SolveResult::Sat) {
+        cout << "SATISFIABLE" << endl;
+        cout << "Assignment: ";
+        for (int lit : finalAssignment) cout << lit << " ";
+        cout << endl;
+    } else if (outcome == SolveResult::Unsat) {
+        cout << "UNSATISFIABLE" << endl;
+    } else {
+        cout << "UNKNOWN" << endl;
+    }
+    printStatistics();
+    return outcome == SolveResult::Sat;
+}
+
+void CDCLSolver::addClause(const vector<int>& literals) {
+    backtrack(0);
+    model.clear();
+
+    vector<int> clause(literals);
+    sort(clause.begin(), clause.end());
+    clause.erase(unique(clause.begin(), clause.end()), clause.end());
+    int maxVar = 0;
+    for (int lit : clause) maxVar = max(maxVar, abs(lit));
+    growVars(maxVar);
+    seen.resize(numVars + 1, 0);
+
+    // Tautologies and clauses satisfied at level 0 are dropped, literals
+    // false at level 0 are left out
+    size_t j = 0;
+    for (size_t i = 0; i < clause.size(); i++) {
+        if (i + 1 < clause.size() && clause[i] == -clause[i + 1]) return;
+        if (literalValue(clause[i]) > 0) return;
+        if (literalValue(clause[i]) == 0) clause[j++] = clause[i];
+    }
+    clause.resize(j);
+
+    if (clause.empty()) {
+        ok = false;
+    } else if (clause.size() == 1 && initialized) {
+        assignValue(clause[0]);
+        assignment.push_back(clause[0]);
+    } else {
+        // Before the first search, initializeWatchedLiterals() takes them
+        CRef cr = ca.alloc(clause);
+        clauses.push_back(cr);
+        if (initialized) attachClause(cr);
+    }
+}
+
+SolveResult CDCLSolver::solve(const vector<int>& assumptions) {
+    model.clear();
+    interrupted = false;
+    failedMark.assign(2 * (static_cast<size_t>(numVars) + 1), 0);
+    if (!ok) return SolveResult::Unsat;
+
+    int maxVar = 0;
+    for (int lit : assumptions) maxVar = max(maxVar, abs(lit));
+    growVars(maxVar);
+    failedMark.resize(2 * (static_cast<size_t>(numVars) + 1), 0);
+
+    if (!initialized) {
+        clearAssignment();
+        seen.assign(numVars + 1, 0);
+        initActivityOrder();
+        restartPolicy.reset();
+        nextReduce = REDUCE_FIRST;
+        reductions = 0;
+        initialized = true;
+
+        // Unit clauses are assigned at level 0 while the watches are built
+        if (!initializeWatchedLiterals()) {
+            ok = false;
+            return SolveResult::Unsat;
+        }
+    } else {
+        backtrack(0);
+        seen.resize(numVars + 1, 0);
+    }
+    if (sharing && !importShared()) {
+        ok = false;
+        return SolveResult::Unsat;
+    }
+
+    vector<int> learnt;
+    while (true) {
+        size_t trailBefore = assignment.size();
+        CRef conflict = propagate();
+        propagations += assignment.size() - trailBefore;
+
+        if (conflict != CREF_UNDEF) {
+            conflicts++;
+            if (decisionLevel() == 0) {
+                // Conflict without any decision: the formula is UNSAT
+                ok = false;
+                return SolveResult::Unsat;
+            }
+
+            // Learn the first-UIP clause and jump back to the level where
+            // it becomes unit (possibly skipping several decision levels)
+            int backjumpLevel = analyze(conflict, learnt);
+            unsigned lbd = computeLbd(learnt.data(), learnt.size());
+            backtrack(backjumpLevel);
+            learnClause(learnt, lbd);
+            decayActivity();
+            decayClauseActivity();
+
+            // Learnt clauses are kept, so restarting loses only the
+            // decisions; the activities steer the next descent
+            restartPolicy.onConflict(lbd);
+            if (restartPolicy.shouldRestart()) {
+                backtrack(0);
+                restartPolicy.onRestart();
+                resetTargetPhase();
+                if (sharing && !importShared()) {
+                    ok = false;
+                    return SolveResult::Unsat;
+                }
+            }
+            if (stopRequested()) {
+                backtrack(0);
+                return SolveResult::Unknown;
+            }
+            continue;
+        }
+
+        if (conflicts >= nextReduce) {
+            reduceDB();
+            reductions++;
+            nextReduce = conflicts + REDUCE_FIRST + reductions * REDUCE_INC;
+        }
+
+        // The assumptions are decided first, one per level; an assumption
+        // that already holds gets an empty level so levels and assumptions
+        // stay aligned
+        int literal = 0;
+        while (decisionLevel() < static_cast<int>(assumptions.size())) {
+            int assumption = assumptions[decisionLevel()];
+            if (literalValue(assumption) > 0) {
+                newDecisionLevel();
+            } else if (literalValue(assumption) < 0) {
+                analyzeFinal(assumption);
+                backtrack(0);
+                return SolveResult::Unsat;
+            } else {
+                literal = assumption;
+                break;
+            }
+        }
+
+        if (literal == 0) {
+            literal = pickBranchLiteral();
+            if (literal == 0) {
+                // Every variable is assigned and no clause is falsified
+                finalAssignment = assignment;
+                model = values;
+                return SolveResult::Sat;
+            }
+        }
+
+        decisions++;
+        newDecisionLevel();
+        assignValue(literal);
+        assignment.push_back(literal);
+    }
+}
+
+int CDCLSolver::modelValue(int literal) const {
+    size_t var = abs(literal);
+    if (var >= model.size()) return 0;
+    return literal > 0 ? model[var] : -model[var];
+}
+
+bool CDCLSolver::failed(int literal) const {
+    size_t index = litIndex(literal);
+    return index < failedMark.size() && failedMark[index];
+}
+
+// The assumption literal is false under the other assumptions: walk its
+// implication graph back to the assumptions it was derived from. Every
+// decision on the trail is an assumption at this point.
+void CDCLSolver::analyzeFinal(int literal) {
+    failedMark[litIndex(literal)] = 1;
+    if (varData[abs(literal)].level == 0) return;
+
+    seen[abs(literal)] = 1;
+    for (size_t i = assignment.size(); i-- > trailLim[0];) {
+        int var = abs(assignment[i]);
+        if (!seen[var]) continue;
+        CRef reason = varData[var].reason;
+        if (reason == CREF_UNDEF) {
+            failedMark[litIndex(assignment[i])] = 1;
+        } else {
+            const Clause clause = ca[reason];
+            for (uint32_t j = 1; j < clause.size(); j++) {
+                if (varData[abs(clause[j])].level > 0) seen[abs(clause[j])] = 1;
+            }
+        }
+        seen[var] = 0;
+    }
+    seen[abs(literal)] = 0;
+}
+
+std::vector<int> CDCLSolver::getAssignment() const {
+    return finalAssignment;
+}
+
+int CDCLSolver::analyze(CRef conflict, vector<int>& learnt) {
+    int pathCount = 0;
+    int p = 0;
+    size_t index = assignment.size();
+    CRef reason = conflict;
+
+    learnt.clear();
+    learnt.push_back(0);  // room for the asserting literal
+
+    // Resolve backwards along the trail until a single literal of the
+    // current decision level is left: the first unique implication point
+    do {
+        const Clause clause = ca[reason];
+        if (clause.learnt()) bumpClause(reason);
+        // The implied literal sits at position 0 of its reason clause
+        for (uint32_t j = (p == 0) ? 0 : 1; j < clause.size(); j++) {
+            int q = clause[j];
+            int var = abs(q);
+            if (!seen[var] && varData[var].level > 0) {
+                seen[var] = 1;
+                bumpActivity(var);
+                if (varData[var].level >= decisionLevel()) {
+                    pathCount++;
+                } else {
+                    learnt.push_back(q);
+                }
+            }
+        }
+
+        // Next marked literal on the trail
+        while (!seen[abs(assignment[--index])]);
+        p = assignment[index];
+        reason = varData[abs(p)].reason;
+        seen[abs(p)] = 0;
+        pathCount--;
+    } while (pathCount > 0);
+    learnt[0] = -p;
+
+    // Drop literals implied by other literals of the clause
+    analyzeToClear.assign(learnt.begin(), learnt.end());
+    size_t j = 1;
+    for (size_t i = 1; i < learnt.size(); i++) {
+        if (!literalRedundant(learnt[i])) learnt[j++] = learnt[i];
+    }
+    learnt.resize(j);
+
+    // The backjump level is the highest level among the other literals;
+    // that literal goes to position 1 so it is watched
+    int backjumpLevel = 0;
+    if (learnt.size() > 1) {
+        size_t maxIndex = 1;
+        for (size_t i = 2; i < learnt.size(); i++) {
+            if (varData[abs(learnt[i])].level > varData[abs(learnt[maxIndex])].level) maxIndex = i;
+        }
+        swap(learnt[1], learnt[maxIndex]);
+        backjumpLevel = varData[abs(learnt[1])].level;
+    }
+
+    for (int lit : analyzeToClear) seen[abs(lit)] = 0;
+    return backjumpLevel;
+}
+
+// A literal is redundant when every other literal of its reason is
+// already in the learnt clause or fixed at level 0
+bool CDCLSolver::literalRedundant(int literal) const {
+    CRef reason = varData[abs(literal)].reason;
+    if (reason == CREF_UNDEF) return false;
+
+    const Clause clause = ca[reason];
+    for (uint32_t k = 1; k < clause.size(); k++) {
+        int var = abs(clause[k]);
+        if (!seen[var] && varData[var].level > 0) return false;
+    }
+    return true;
+}
+
+void CDCLSolver::learnClause(const vector<int>& learnt, unsigned lbd) {
+    if (learnCallback && static_cast<int>(learnt.size()) <= learnMaxSize) learnCallback(learnt);
+    if (sharing) sharing->exportClause(learnt, lbd);
+
+    if (learnt.size() == 1) {
+        // Learnt units hold at level 0
+        assignValue(learnt[0]);
+        assignment.push_back(learnt[0]);
+        return;
+    }
+
+    CRef cr = ca.alloc(learnt, true);
+    ca[cr].setLbd(lbd);
+    learnts.push_back(cr);
+    attachClause(cr);
+    assignValue(learnt[0], cr);
+    assignment.push_back(learnt[0]);
+}
+
+// Clauses shared by the other solvers join the learnt clauses, simplified
+// by the level-0 assignment. False if one of them is falsified there. At
+// level 0 only, so every clause left with two or more literals can watch
+// its first two.
+bool CDCLSolver::importShared() {
+    imports.clear();
+    sharing->importClauses(imports);
+    for (SharedClause& shared : imports) {
+        vector<int>& clause = shared.literals;
+        bool satisfied = false;
+        size_t j = 0;
+        for (int lit : clause) {
+            if (abs(lit) > numVars || literalValue(lit) > 0) {
+                satisfied = true;  // or not about this formula's variables
+                break;
+            }
+            if (literalValue(lit) == 0) clause[j++] = lit;
+        }
+        if (satisfied) continue;
+        clause.resize(j);
+
+        if (clause.empty()) return false;
+        if (clause.size() == 1) {
+            assignValue(clause[0]);
+            assignment.push_back(clause[0]);
+            continue;
+        }
+        CRef cr = ca.alloc(clause, true);
+        ca[cr].setLbd(min<unsigned>(shared.lbd, static_cast<unsigned>(clause.size()) - 1));
+        learnts.push_back(cr);
+        attachClause(cr);
+    }
+    return true;
+}
+
+// A learnt clause took part in a conflict: raise its activity, mark it as
+// used and tighten its LBD, which may move it to a better tier
+void CDCLSolver::bumpClause(CRef cr) {
+    Clause clause = ca[cr];
+    clause.setUsed(true);
+    if (clause.lbd() > CORE_LBD) {
+        unsigned lbd = computeLbd(clause.begin(), clause.size());
+        if (lbd < clause.lbd()) clause.setLbd(lbd);
+    }
+
+    clause.setActivity(static_cast<float>(clause.activity() + claInc));
+    if (clause.activity() > 1e20f) {
+        for (CRef lcr : learnts) {
+            Clause c = ca[lcr];
+            c.setActivity(c.activity() * 1e-20f);
+        }
+        claInc *= 1e-20;
+    }
+}
+
+// The reason of an assigned literal must stay in the database
+bool CDCLSolver::locked(CRef cr) const {
+    const Clause clause = ca[cr];
+    return literalValue(clause[0]) > 0 && varData[abs(clause[0])].reason == cr;
+}
+
+void CDCLSolver::reduceDB() {
+    vector<CRef> local;
+    for (CRef cr : learnts) {
+        Clause clause = ca[cr];
+        bool used = clause.used();
+        clause.setUsed(false);
+        if (clause.lbd() <= CORE_LBD) continue;
+        if (clause.lbd() <= TIER2_LBD && used) continue;
+        if (clause.size() <= 2 || locked(cr)) continue;
+        local.push_back(cr);
+    }
+
+    // Least active first; among equal activities the higher LBD goes first
+    sort(local.begin(), local.end(), [this](CRef a, CRef b) {
+        const Clause first = ca[a];
+        const Clause second = ca[b];
+        if (first.activity() != second.activity()) return first.activity() < second.activity();
+        return first.lbd() > second.lbd();
+    });
+    for (size_t i = 0; i < local.size() / 2; i++) {
+        ca.free(local[i]);
+        deletedLearnts++;
+    }
+
+    // Drop the deleted clauses from the learnt list and the watch lists
+    size_t j = 0;
+    for (CRef cr : learnts) {
+        if (!ca[cr].deleted()) learnts[j++] = cr;
+    }
+    learnts.resize(j);
+    for (auto& list : watches) {
+        list.erase(remove_if(list.begin(), list.end(),
+                             [this](const Watcher& w) { return ca[w.cref].deleted(); }),
+                   list.end());
+    }
+
+    checkGarbage();
+}
+
+void CDCLSolver::relocateClauses(ClauseArena& to) {
+    SATSolver::relocateClauses(to);
+    for (CRef& cr : learnts) ca.relocate(cr, to);
+}
+
+int CDCLSolver::pickBranchLiteral() {
+    // VSIDS: most active unassigned variable; its saved or target phase,
+    // negative when it has none yet
+    int var = pickActivityVariable();
+    if (var == 0) return 0;
+    return pickPhase(var, -var);
+}
+
+void CDCLSolver::printStatistics() const {
+    cout << "Conflicts: " << conflicts << endl;
+    cout << "Decisions: " << decisions << endl;
+    cout << "Propagations: " << propagations << endl;
+    cout << "Restarts: " << restartPolicy.getRestarts() << endl;
+    cout << "Learnt clauses: " << learnts.size() << endl;
+    cout << "Deleted clauses: " << deletedLearnts << endl;
+}
@@ -0,0 +1,106 @@
+#ifndef CDCLSOLVER_H
+#define CDCLSOLVER_H
+
+#include "../general/satsolver.h"
+#include "../general/clausesharing.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <functional>
+
+// The solver is incremental: clauses may be added between calls to
+// solve(assumptions), and learnt clauses, activities and phases carry over
+// from one call to the next. Learnt clauses never depend on assumptions,
+// so they stay valid for every later call.
+class CDCLSolver : public SATSolver {
+public:
+    CDCLSolver();  // empty formula, for incremental use
+    CDCLSolver(const std::string& filename);
+    explicit CDCLSolver(std::shared_ptr<const Formula> formula);
+
+    // Returns true if SAT, false if UNSAT; prints the result
+    bool solve();
+
+    // Returns the satisfying assignment (if any)
+    std::vector<int> getAssignment() const;
+
+    // Incremental interface. addClause() takes the literals without the
+    // terminating 0. solve(assumptions) searches quietly for a model in
+    // which every assumption literal holds; assumptions last for this call
+    // only. After Sat, modelValue() gives the model (1 true, -1 false, 0
+    // unknown variable); after Unsat, failed() tells which assumptions
+    // were needed for the refutation (none if the clauses alone are UNSAT).
+    void addClause(const std::vector<int>& literals);
+    SolveResult solve(const std::vector<int>& assumptions);
+    int modelValue(int literal) const;
+    bool failed(int literal) const;
+
+    // Called with every learnt clause of at most maxSize literals
+    void setLearnCallback(int maxSize, std::function<void(const std::vector<int>&)> callback) {
+        learnMaxSize = maxSize;
+        learnCallback = std::move(callback);
+    }
+
+    // Parallel solving on the same formula (see general/clausesharing.h):
+    // every learnt clause is offered to sharing, and the clauses of the
+    // other solvers are taken in at each restart. nullptr to stop.
+    void setClauseSharing(ClauseSharing* sharing) { this->sharing = sharing; }
+
+    uint64_t getConflicts() const { return conflicts; }
+    uint64_t getDecisions() const { return decisions; }
+    uint64_t getPropagations() const { return propagations; }
+    size_t getNumLearnts() const { return learnts.size(); }
+    uint64_t getDeletedLearnts() const { return deletedLearnts; }
+
+private:
+    // First-UIP conflict analysis: fills learnt with the asserting clause
+    // (asserting literal first) and returns the level to backjump to
+    int analyze(CRef conflict, std::vector<int>& learnt);
+    bool literalRedundant(int literal) const;
+    void analyzeFinal(int literal);
+    void learnClause(const std::vector<int>& learnt, unsigned lbd);
+    bool importShared();
+    int pickBranchLiteral();
+    void printStatistics() const;
+
+    // Learnt clause database. Clauses are kept by LBD tier: core (LBD <= 2)
+    // forever, tier2 (LBD <= 6) as long as they keep taking part in
+    // conflicts, and the rest (local) only while their activity is in the
+    // better half. reduceDB() runs every REDUCE_FIRST + k * REDUCE_INC
+    // conflicts and compacts the arena when enough of it is freed.
+    void bumpClause(CRef cr);
+    void decayClauseActivity() { claInc /= claDecay; }
+    bool locked(CRef cr) const;
+    void reduceDB();
+    void relocateClauses(ClauseArena& to) override;
+
+    static const unsigned CORE_LBD = 2;
+    static const unsigned TIER2_LBD = 6;
+    static const uint64_t REDUCE_FIRST = 2000;
+    static const uint64_t REDUCE_INC = 300;
+
+    std::vector<CRef> learnts;           // learned clauses, stored in the arena
+    double claInc = 1.0;
+    double claDecay = 0.999;
+    uint64_t nextReduce = REDUCE_FIRST;
+    uint64_t reductions = 0;
+    uint64_t deletedLearnts = 0;
+    std::vector<unsigned char> seen;     // scratch marks for analyze()
+    std::vector<int> analyzeToClear;
+    std::vector<int> finalAssignment;
+
+    bool initialized = false;  // watches and order heap built
+    bool ok = true;            // false once the clauses alone are UNSAT
+    std::vector<signed char> model;
+    std::vector<unsigned char> failedMark;  // by litIndex
+    std::function<void(const std::vector<int>&)> learnCallback;
+    int learnMaxSize = 0;
+    ClauseSharing* sharing = nullptr;
+    std::vector<SharedClause> imports;  // scratch for importShared()
+
+    uint64_t conflicts = 0;
+    uint64_t decisions = 0;
+    uint64_t propagations = 0;
+};
+
+#endif // CDCLSOLVER_H
@@ -0,0 +1,504 @@
+#include "./cli.h"
+#include "../dpll/dpllsolver.h"
+#include "../dp/dpsolver.h"
+#include "../res/resolutionsolver.h"
+#include "../cdcl/cdclsolver.h"
+#include "../general/formula.h"
+#include "../general/log.h"
+#include "../general/threadpool.h"
+#include "../portfolio/threadportfolio.h"
+#include "../dpll/paralleldpll.h"
+#include "./heapusage.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <algorithm>
+#include <new>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+volatile sig_atomic_t interruptRequested = 0;
+
+void onInterrupt(int) {
+    interruptRequested = 1;
+}
+
+// Swallows the progress output the solvers write to cout
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+void printUsage(ostream& out) {
+    out << "Usage: MPI_SAT_Unified [options] [file|directory]...\n"
+           "Without arguments the interactive menu starts.\n"
+           "\n"
+           "Options:\n"
+           "  -s, --solver NAME    dpll, dp, res, cdcl, portfolio or pdpll (default cdcl)\n"
+           "  -t, --timeout SEC    time limit per instance in seconds (default none)\n"
+           "  -m, --memory MIB     memory limit for the process in MiB (default none)\n"
+           "  -j, --threads N      parser threads, 0 for all cores (default 0, 1 with -p)\n"
+           "  -p, --jobs N         instances solved at once, 0 for all cores (default 1)\n"
+           "  -w, --workers N      threads of the portfolio and pdpll solvers, 0 for all cores\n"
+           "                       (default 0, the cores shared out with -p)\n"
+           "  -M, --manifest FILE  solve the files and directories listed in FILE\n"
+           "  -o, --output FILE    write the results to FILE instead of stdout\n"
+           "  -f, --format NAME    text, csv or json (default text)\n"
+           "  -l, --log LEVEL      none, error, info, debug or trace (log goes to stderr)\n"
+           "  -n, --no-model       leave out the v lines of the text format\n"
+           "  -h, --help           show this help\n"
+           "\n"
+           "Directories are searched recursively for *.cnf, *.cnf.gz, *.cnf.xz,\n"
+           "*.cnf.bz2 and *.snap files. A manifest lists one file or directory per\n"
+           "line; blank lines and lines starting with # are skipped.\n"
+           "Exit code: 10 if every instance is SAT, 20 if every instance is UNSAT,\n"
+           "0 otherwise, 1 for a usage error.\n";
+}
+
+bool parseNumber(const string& text, double& value) {
+    istringstream in(text);
+    in >> value;
+    return in && in.eof() && value >= 0;
+}
+
+bool isInputName(const string& name) {
+    static const char* suffixes[] = {".cnf", ".cnf.gz", ".cnf.xz", ".cnf.bz2", ".snap"};
+    for (const char* suffix : suffixes) {
+        string s(suffix);
+        if (name.size() > s.size() && name.compare(name.size() - s.size(), s.size(), s) == 0) return true;
+    }
+    return false;
+}
+
+string jsonEscape(const string& text) {
+    string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            out += code;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+string csvField(const string& text) {
+    if (text.find_first_of(",\"\n") == string::npos) return text;
+    string out = "\"";
+    for (char c : text) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+template <typename Solver>
+void runSolver(Solver& solver, InstanceResult& result) {
+    bool sat = solver.solve();
+    result.restarts = solver.getRestarts();
+    if (solver.wasInterrupted()) {
+        result.status = "UNKNOWN";
+    } else if (sat) {
+        result.status = "SAT";
+        result.model = solver.getAssignment();
+    } else {
+        result.status = "UNSAT";
+    }
+}
+
+void printResult(ostream& out, const InstanceResult& result, const CliOptions& options, bool first) {
+    switch (options.format) {
+        case OutputFormat::Text: {
+            out << "c " << result.file << "\n";
+            out << "c solver " << options.solver << ", " << result.timeMs << " ms, " << result.variables
+                << " variables, " << result.clauses << " clauses, " << result.peakMemoryKb << " KiB\n";
+            out << "c " << result.conflicts << " conflicts, " << result.decisions << " decisions, "
+                << result.propagations << " propagations, " << result.restarts << " restarts\n";
+            if (result.status == "SAT") {
+                out << "s SATISFIABLE\n";
+            } else if (result.status == "UNSAT") {
+                out << "s UNSATISFIABLE\n";
+            } else {
+                if (result.status != "UNKNOWN") out << "c " << result.status << (result.message.empty() ? "" : ": ") << result.message << "\n";
+                out << "s UNKNOWN\n";
+            }
+            if (result.status == "SAT" && options.printModel && result.model.empty() && result.variables > 0) {
+                out << "c no model: solver " << options.solver << " did not build a complete one\n";
+            } else if (result.status == "SAT" && options.printModel) {
+                vector<int> model = result.model;
+                sort(model.begin(), model.end(), [](int a, int b) { return abs(a) < abs(b); });
+                string line = "v";
+                for (int lit : model) {
+                    string token = " " + to_string(lit);
+                    if (line.size() + token.size() > 78) {
+                        out << line << "\n";
+                        line = "v";
+                    }
+                    line += token;
+                }
+                out << line << " 0\n";
+            }
+            break;
+        }
+        case OutputFormat::Csv:
+            if (first) out << "file,solver,status,time_ms,variables,clauses,peak_kb,conflicts,decisions,propagations,restarts,message\n";
+            out << csvField(result.file) << "," << options.solver << "," << result.status << "," << result.timeMs
+                << "," << result.variables << "," << result.clauses << "," << result.peakMemoryKb << ","
+                << result.conflicts << "," << result.decisions << "," << result.propagations << "," << result.restarts
+                << "," << csvField(result.message) << "\n";
+            break;
+        case OutputFormat::Json:
+            out << (first ? "[\n" : ",\n");
+            out << "  {\"file\": \"" << jsonEscape(result.file) << "\", \"solver\": \"" << options.solver
+                << "\", \"status\": \"" << result.status << "\", \"time_ms\": " << result.timeMs
+                << ", \"variables\": " << result.variables << ", \"clauses\": " << result.clauses
+                << ", \"peak_kb\": " << result.peakMemoryKb << ", \"conflicts\": " << result.conflicts
+                << ", \"decisions\": " << result.decisions << ", \"propagations\": " << result.propagations
+                << ", \"restarts\": " << result.restarts;
+            if (!result.message.empty()) out << ", \"message\": \"" << jsonEscape(result.message) << "\"";
+            out << "}";
+            break;
+    }
+    out.flush();
+}
+
+} // namespace
+
+bool parseCommandLine(int argc, char** argv, CliOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string value;
+        bool hasValue = false;
+
+        // --name=value as well as --name value
+        size_t equals = arg.find('=');
+        if (arg.rfind("--", 0) == 0 && equals != string::npos) {
+            value = arg.substr(equals + 1);
+            arg = arg.substr(0, equals);
+            hasValue = true;
+        }
+        auto next = [&](string& out) {
+            if (hasValue) {
+                out = value;
+                return true;
+            }
+            if (i + 1 >= argc) {
+                cerr << "Missing value for " << arg << "\n";
+                return false;
+            }
+            out = argv[++i];
+            return true;
+        };
+
+        double number = 0;
+        if (arg == "-h" || arg == "--help") {
+            printUsage(cout);
+            exit(0);
+        } else if (arg == "-s" || arg == "--solver") {
+            if (!next(options.solver)) return false;
+            if (options.solver != "dpll" && options.solver != "dp" && options.solver != "res" && options.solver != "cdcl" &&
+                options.solver != "portfolio" && options.solver != "pdpll") {
+                cerr << "Unknown solver: " << options.solver << "\n";
+                return false;
+            }
+        } else if (arg == "-t" || arg == "--timeout") {
+            if (!next(value) || !parseNumber(value, number)) {
+                cerr << "Invalid timeout\n";
+                return false;
+            }
+            options.timeout = number;
+        } else if (arg == "-m" || arg == "--memory") {
+            if (!next(value) || !parseNumber(value, number)) {
+                cerr << "Invalid memory limit\n";
+                return false;
+            }
+            options.memoryLimit = static_cast<size_t>(number);
+        } else if (arg == "-j" || arg == "--threads") {
+            if (!next(value) || !parseNumber(value, number)) {
+                cerr << "Invalid thread count\n";
+                return false;
+            }
+            options.threads = static_cast<unsigned>(number);
+        } else if (arg == "-p" || arg == "--jobs") {
+            if (!next(value) || !parseNumber(value, number)) {
+                cerr << "Invalid job count\n";
+                return false;
+            }
+            options.jobs = static_cast<unsigned>(number);
+        } else if (arg == "-w" || arg == "--workers") {
+            if (!next(value) || !parseNumber(value, number)) {
+                cerr << "Invalid worker count\n";
+                return false;
+            }
+            options.workers = static_cast<unsigned>(number);
+        } else if (arg == "-M" || arg == "--manifest") {
+            if (!next(value)) return false;
+            options.manifests.push_back(value);
+        } else if (arg == "-o" || arg == "--output") {
+            if (!next(options.output)) return false;
+        } else if (arg == "-f" || arg == "--format") {
+            if (!next(value)) return false;
+            if (value == "text") {
+                options.format = OutputFormat::Text;
+            } else if (value == "csv") {
+                options.format = OutputFormat::Csv;
+            } else if (value == "json") {
+                options.format = OutputFormat::Json;
+            } else {
+                cerr << "Unknown format: " << value << "\n";
+                return false;
+            }
+        } else if (arg == "-l" || arg == "--log") {
+            if (!next(value)) return false;
+            int level = satlog::parseLevel(value.c_str());
+            if (level < 0) {
+                cerr << "Unknown log level: " << value << "\n";
+                return false;
+            }
+            satlog::setLevel(level);
+        } else if (arg == "-n" || arg == "--no-model") {
+            options.printModel = false;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            cerr << "Unknown option: " << arg << "\n";
+            return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    if (options.inputs.empty() && options.manifests.empty()) {
+        cerr << "No input files\n";
+        return false;
+    }
+    return true;
+}
+
+vector<string> collectInputs(const vector<string>& inputs) {
+    vector<string> files;
+    for (const string& input : inputs) {
+        error_code error;
+        if (!fs::is_directory(input, error)) {
+            files.push_back(input);
+            continue;
+        }
+        vector<string> found;
+        for (const auto& entry : fs::recursive_directory_iterator(input, error)) {
+            if (entry.is_regular_file(error) && isInputName(entry.path().filename().string())) {
+                found.push_back(entry.path().string());
+            }
+        }
+        sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+}
+
+vector<string> readManifest(const string& manifest) {
+    ifstream in(manifest);
+    if (!in) throw runtime_error("Failed to open manifest: " + manifest);
+    fs::path directory = fs::path(manifest).parent_path();
+    vector<string> entries;
+    string line;
+    while (getline(in, line)) {
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == string::npos || line[begin] == '#') continue;
+        size_t end = line.find_last_not_of(" \t\r");
+        fs::path entry = line.substr(begin, end - begin + 1);
+        entries.push_back(entry.is_absolute() ? entry.string() : (directory / entry).string());
+    }
+    return entries;
+}
+
+InstanceResult solveInstance(const string& file, const CliOptions& options) {
+    InstanceResult result;
+    result.file = file;
+
+    auto start = chrono::steady_clock::now();
+    auto deadline = chrono::steady_clock::time_point::max();
+    if (options.timeout > 0) {
+        deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(options.timeout));
+    }
+    auto stop = [deadline]() { return interruptRequested || chrono::steady_clock::now() >= deadline; };
+
+    HeapMeasurement heap;
+    try {
+        auto formula = Formula::load(file, options.threads);
+        result.variables = formula->getNumVars();
+        result.clauses = formula->getNumParsedClauses();
+
+        if (options.solver == "dpll") {
+            DPLLSolver solver(formula);
+            solver.setTerminate(stop);
+            runSolver(solver, result);
+            result.conflicts = solver.getConflicts();
+            result.decisions = solver.getDecisions();
+        } else if (options.solver == "dp") {
+            DPSolver solver(formula);
+            solver.setTerminate(stop);
+            runSolver(solver, result);
+        } else if (options.solver == "res") {
+            ResolutionSolver solver(formula);
+            solver.setTerminate(stop);
+            bool sat = solver.solve();
+            result.status = solver.wasInterrupted() ? "UNKNOWN" : (sat ? "SAT" : "UNSAT");
+        } else if (options.solver == "portfolio") {
+            ThreadPortfolioResult portfolio = runThreadPortfolio(formula, options.workers, stop);
+            result.status = portfolio.status == SolveResult::Sat     ? "SAT"
+                            : portfolio.status == SolveResult::Unsat ? "UNSAT"
+                                                                     : "UNKNOWN";
+            result.model = move(portfolio.model);
+        } else if (options.solver == "pdpll") {
+            ParallelDPLLResult search = runParallelDPLL(formula, options.workers, BranchHeuristic::MaxFrequency, stop);
+            result.status = search.status == SolveResult::Sat     ? "SAT"
+                            : search.status == SolveResult::Unsat ? "UNSAT"
+                                                                  : "UNKNOWN";
+            result.model = move(search.model);
+            result.conflicts = search.conflicts;
+            result.decisions = search.decisions;
+        } else {
+            CDCLSolver solver(formula);
+            solver.setTerminate(stop);
+            runSolver(solver, result);
+            result.conflicts = solver.getConflicts();
+            result.decisions = solver.getDecisions();
+            result.propagations = solver.getPropagations();
+        }
+        if (result.status == "UNKNOWN" && chrono::steady_clock::now() >= deadline) result.status = "TIMEOUT";
+        // Resolution keeps no assignment and DP does not give eliminated
+        // variables back their values, so SAT can come without a model
+        if (!formula->isModel(result.model)) result.model.clear();
+    } catch (const bad_alloc&) {
+        result.status = "MEMOUT";
+    } catch (const exception& e) {
+        result.status = "ERROR";
+        result.message = e.what();
+    }
+    satlog::flush();
+
+    result.peakMemoryKb = heap.peakBytes() >> 10;
+    result.timeMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+int runCommandLine(int argc, char** argv) {
+    CliOptions options;
+    if (!parseCommandLine(argc, argv, options)) {
+        printUsage(cerr);
+        return 1;
+    }
+
+    // Results own stdout; log lines go to stderr
+    satlog::setOutput(stderr);
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onInterrupt);
+
+    if (options.memoryLimit > 0) {
+#ifdef _WIN32
+        cerr << "Warning: --memory is not supported on this platform\n";
+#else
+        rlimit limit;
+        limit.rlim_cur = static_cast<rlim_t>(options.memoryLimit) << 20;
+        limit.rlim_max = limit.rlim_cur;
+        if (setrlimit(RLIMIT_AS, &limit) != 0) cerr << "Warning: could not set the memory limit\n";
+#endif
+    }
+
+    vector<string> inputs = options.inputs;
+    try {
+        for (const string& manifest : options.manifests) {
+            vector<string> entries = readManifest(manifest);
+            inputs.insert(inputs.end(), entries.begin(), entries.end());
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+    vector<string> files = collectInputs(inputs);
+    if (files.empty()) {
+        cerr << "No CNF files found\n";
+        return 1;
+    }
+
+    ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            cerr << "Failed to create output file: " << options.output << "\n";
+            return 1;
+        }
+    }
+
+    // The solvers report progress on cout; only the results are printed
+    NullBuffer null;
+    ostream out(options.output.empty() ? cout.rdbuf() : file.rdbuf());
+    streambuf* console = cout.rdbuf(&null);
+
+    // Parallel instances already use the cores; parsing each of them on
+    // all cores as well would only oversubscribe them
+    CliOptions instanceOptions = options;
+    if (options.jobs != 1 && options.threads == 0) instanceOptions.threads = 1;
+    if (options.jobs != 1 && options.workers == 0) {
+        unsigned cores = max(1u, thread::hardware_concurrency());
+        instanceOptions.workers = max(1u, cores / (options.jobs == 0 ? cores : options.jobs));
+    }
+
+    // Results are printed in input order: each finished instance prints
+    // itself and every later one that finished before it
+    vector<optional<InstanceResult>> results(files.size());
+    size_t printed = 0;
+    size_t reported = 0;
+    bool allSat = true;
+    bool allUnsat = true;
+    mutex lock;
+    auto report = [&](const InstanceResult& result) {
+        printResult(out, result, options, reported++ == 0);
+        allSat = allSat && result.status == "SAT";
+        allUnsat = allUnsat && result.status == "UNSAT";
+    };
+
+    {
+        ThreadPool pool(options.jobs);
+        for (size_t i = 0; i < files.size(); i++) {
+            pool.submit([&, i]() {
+                if (interruptRequested) return;
+                InstanceResult result = solveInstance(files[i], instanceOptions);
+                lock_guard<mutex> guard(lock);
+                results[i] = move(result);
+                for (; printed < results.size() && results[printed]; printed++) {
+                    report(*results[printed]);
+                    results[printed]->model.clear();
+                }
+            });
+        }
+        pool.wait();
+    }
+    // After an interrupt, what finished beyond the first skipped instance
+    for (; printed < results.size(); printed++) {
+        if (results[printed]) report(*results[printed]);
+    }
+    if (options.format == OutputFormat::Json) out << (reported == 0 ? "[" : "\n") << "]\n";
+    out.flush();
+    cout.rdbuf(console);
+
+    if (interruptRequested || reported < files.size()) return static_cast<int>(SolveResult::Unknown);
+    if (allSat) return static_cast<int>(SolveResult::Sat);
+    if (allUnsat) return static_cast<int>(SolveResult::Unsat);
+    return static_cast<int>(SolveResult::Unknown);
+}
@@ -0,0 +1,75 @@
+#ifndef CLI_H
+#define CLI_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "../general/satsolver.h"
+
+#pragma once
+
+using namespace std;
+
+// Non-interactive front end, used when the program gets arguments:
+//
+//   MPI_SAT_Unified [options] <file|directory>...
+//
+// Every file (directories are searched for CNF files, manifests list
+// them) is solved and reported in the chosen format, in input order. With
+// --jobs the instances run side by side on a thread pool, each with its
+// own time limit. The exit code follows the SAT competition:
+// 10 if every instance is SAT, 20 if every instance is UNSAT, 0 otherwise,
+// and 1 for a usage error.
+enum class OutputFormat { Text, Csv, Json };
+
+struct CliOptions {
+    string solver = "cdcl";  // dpll, dp, res, cdcl, portfolio or pdpll
+    vector<string> inputs;   // files and directories as given
+    vector<string> manifests; // text files listing more inputs
+    double timeout = 0;      // seconds per instance, 0 for none
+    size_t memoryLimit = 0;  // MiB for the whole process, 0 for none
+    unsigned threads = 0;    // parser threads, 0 for all cores (1 when jobs > 1)
+    unsigned jobs = 1;       // instances solved at once, 0 for all cores
+    unsigned workers = 0;    // portfolio and pdpll threads, 0 for all cores (shared out when jobs > 1)
+    string output;           // result file, empty for stdout
+    OutputFormat format = OutputFormat::Text;
+    bool printModel = true;  // v lines in text output
+};
+
+// Outcome of one instance
+struct InstanceResult {
+    string file;
+    string status;  // SAT, UNSAT, UNKNOWN, TIMEOUT, MEMOUT or ERROR
+    string message; // error text for ERROR
+    long long timeMs = 0;
+    int variables = 0;
+    size_t clauses = 0;
+    size_t peakMemoryKb = 0; // heap of the threads solving it, see heapusage.h
+    uint64_t conflicts = 0;  // counters the solver keeps, 0 otherwise
+    uint64_t decisions = 0;
+    uint64_t propagations = 0;
+    uint64_t restarts = 0;
+    vector<int> model;       // after SAT, only if it satisfies every clause
+};
+
+// Parses argv into options; returns false and prints usage on bad input
+bool parseCommandLine(int argc, char** argv, CliOptions& options);
+
+// Files named on the command line plus the CNF files under the named
+// directories, each directory in sorted order
+vector<string> collectInputs(const vector<string>& inputs);
+
+// Entries of a manifest: one file or directory per line, blank lines and
+// lines starting with # skipped, relative paths taken from the manifest's
+// directory. Throws runtime_error if the manifest cannot be read.
+vector<string> readManifest(const string& manifest);
+
+// Solves one file under the options' time limit. Safe to call from several
+// threads at once; the solvers' progress output on cout is left to the
+// caller to silence.
+InstanceResult solveInstance(const string& file, const CliOptions& options);
+
+int runCommandLine(int argc, char** argv);
+
+#endif // CLI_H
@@ -0,0 +1,147 @@
+#include "./heapusage.h"
+#include "../general/threadpool.h"
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <atomic>
+
+namespace {
+
+// Each block starts with its size and the account it is charged to,
+// padded to keep the maximal alignment
+struct BlockHeader {
+    size_t size;
+    HeapAccount* owner;
+};
+const size_t HEADER = alignof(std::max_align_t);
+static_assert(sizeof(BlockHeader) <= HEADER, "block header does not fit the alignment padding");
+
+} // namespace
+
+// An account lives as long as anything refers to it: its measurement or
+// thread, and every block charged to it that is not freed yet. It comes
+// from malloc, so opening one never recurses into operator new.
+struct HeapAccount {
+    std::atomic<int64_t> current{0};  // bytes, may go below 0 when older memory is freed
+    std::atomic<int64_t> peak{0};
+    std::atomic<int64_t> holders{1};
+};
+
+namespace {
+
+HeapAccount* openAccount() {
+    void* memory = malloc(sizeof(HeapAccount));
+    if (memory == nullptr) throw std::bad_alloc();
+    return new (memory) HeapAccount();
+}
+
+void hold(HeapAccount* account) {
+    account->holders.fetch_add(1, std::memory_order_relaxed);
+}
+
+void drop(HeapAccount* account) {
+    if (account->holders.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        account->~HeapAccount();
+        free(account);
+    }
+}
+
+// The thread's own account, opened with its first allocation
+struct OwnAccount {
+    HeapAccount* account = nullptr;
+    ~OwnAccount() {
+        if (account != nullptr) drop(account);
+        account = nullptr;
+    }
+};
+
+thread_local OwnAccount own;
+thread_local HeapAccount* charged = nullptr;  // the account in use, own if null
+
+HeapAccount* account() {
+    if (charged != nullptr) return charged;
+    if (own.account == nullptr) own.account = openAccount();
+    return own.account;
+}
+
+void charge(HeapAccount* target, int64_t bytes) {
+    int64_t now = target->current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t high = target->peak.load(std::memory_order_relaxed);
+    while (now > high && !target->peak.compare_exchange_weak(high, now, std::memory_order_relaxed)) {
+    }
+}
+
+void* allocate(size_t size) {
+    while (true) {
+        void* block = malloc(size + HEADER);
+        if (block != nullptr) {
+            HeapAccount* owner = account();
+            hold(owner);
+            charge(owner, static_cast<int64_t>(size));
+            *static_cast<BlockHeader*>(block) = {size, owner};
+            return static_cast<char*>(block) + HEADER;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void release(void* pointer) noexcept {
+    if (pointer == nullptr) return;
+    char* block = static_cast<char*>(pointer) - HEADER;
+    BlockHeader header = *reinterpret_cast<BlockHeader*>(block);
+    charge(header.owner, -static_cast<int64_t>(header.size));
+    drop(header.owner);
+    free(block);
+}
+
+// Pool workers carry on the account of the thread that built the pool
+const bool poolsCharged = [] {
+    ThreadPool::setThreadContext([]() -> void* { return account(); },
+                                 [](void* context) { charged = static_cast<HeapAccount*>(context); });
+    return true;
+}();
+
+} // namespace
+
+HeapMeasurement::HeapMeasurement() : account(openAccount()), previous(charged) {
+    charged = account;
+}
+
+HeapMeasurement::~HeapMeasurement() {
+    charged = previous;
+    drop(account);
+}
+
+size_t HeapMeasurement::peakBytes() const {
+    int64_t peak = account->peak.load(std::memory_order_relaxed);
+    return peak > 0 ? static_cast<size_t>(peak) : 0;
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
@@ -0,0 +1,40 @@
+#ifndef HEAPUSAGE_H
+#define HEAPUSAGE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#pragma once
+
+// Heap use per instance, for the peak memory of instances solved side by
+// side in one process (the process peak RSS would mix them). The program's
+// operator new and delete are replaced: every allocation is charged to the
+// account of the thread making it, and its release to that same account,
+// whichever thread frees it. A thread has an account of its own until it
+// starts a HeapMeasurement; the workers of a ThreadPool take the account
+// of the thread that built the pool, so the threads of the portfolio and
+// pdpll solvers count towards their instance. Memory of the parser and
+// decompression helper threads is not charged to the instance, and mapped
+// snapshots are not heap.
+
+struct HeapAccount;
+
+// Charges the calling thread, and the workers of the pools it builds while
+// the measurement lasts, to a fresh account; measurements nest
+class HeapMeasurement {
+public:
+    HeapMeasurement();
+    ~HeapMeasurement();
+
+    HeapMeasurement(const HeapMeasurement&) = delete;
+    HeapMeasurement& operator=(const HeapMeasurement&) = delete;
+
+    // Highest heap use since construction, in bytes
+    size_t peakBytes() const;
+
+private:
+    HeapAccount* account;
+    HeapAccount* previous;
+};
+
+#endif // HEAPUSAGE_H
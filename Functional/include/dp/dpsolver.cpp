@@ -1,6 +1,7 @@
 #include "../general/satsolver.h"
 #include "./dpsolver.h"
 #include "../res/resolutionsolver.h"
+#include "../general/log.h"
 #include <iostream>
 #include <vector>
 #include <algorithm>
@@ -8,11 +9,11 @@
 using namespace std;
 
 
-vector<vector<int>> DPSolver::singleStep(const vector<vector<int>>& clauseSet) {
-    vector<vector<int>> result = clauseSet;
+vector<CRef> DPSolver::singleStep(const vector<CRef>& clauseSet) {
+    vector<CRef> result = clauseSet;
 
     // Helper function to calculate clause score (lower is better)
-    auto getClauseScore = [](const vector<int>& c1, const vector<int>& c2) -> int {
+    auto getClauseScore = [](const Clause& c1, const Clause& c2) -> int {
         return c1.size() + c2.size();  // Prefer shorter clauses
     };
 
@@ -22,8 +23,8 @@ vector<vector<int>> DPSolver::singleStep(const vector<vector<int>>& clauseSet) {
     // Find candidate pairs for resolution
     for (size_t i = 0; i < clauseSet.size(); i++) {
         for (size_t j = i + 1; j < clauseSet.size(); j++) {
-            const auto& clause1 = clauseSet[i];
-            const auto& clause2 = clauseSet[j];
+            const Clause clause1 = ca[clauseSet[i]];
+            const Clause clause2 = ca[clauseSet[j]];
 
             // Check for complementary literals
             for (int lit1 : clause1) {
@@ -41,8 +42,8 @@ vector<vector<int>> DPSolver::singleStep(const vector<vector<int>>& clauseSet) {
 
     // Try candidates until we find a useful resolvent
     for (const auto& candidate : candidates) {
-        const auto& clause1 = clauseSet[candidate.second.first];
-        const auto& clause2 = clauseSet[candidate.second.second];
+        const Clause clause1 = ca[clauseSet[candidate.second.first]];
+        const Clause clause2 = ca[clauseSet[candidate.second.second]];
 
         // Generate resolvent
         set<int> resolvent;
@@ -81,7 +82,8 @@ vector<vector<int>> DPSolver::singleStep(const vector<vector<int>>& clauseSet) {
             // Check if resolvent is new
             vector<int> resolventVec(resolvent.begin(), resolvent.end());
             bool isNew = true;
-            for (const auto& existing : result) {
+            for (CRef cr : result) {
+                const Clause existing = ca[cr];
                 if (existing.size() == resolventVec.size() &&
                     is_permutation(existing.begin(), existing.end(), resolventVec.begin())) {
                     isNew = false;
@@ -91,13 +93,10 @@ vector<vector<int>> DPSolver::singleStep(const vector<vector<int>>& clauseSet) {
 
             // If resolvent is useful and new, add it and return
             if (isNew) {
-                cout << "[DEBUG] New resolvent found: ";
-                for (int lit : resolventVec) {
-                    cout << lit << " ";
-                }
-                cout << endl;
+                LOG_DEBUG("New resolvent found: " << satlog::join(resolventVec));
 
-                result.push_back(resolventVec);
+                // Derived clauses go to the arena flagged as learnt
+                result.push_back(ca.alloc(resolventVec, true));
                 return result;
             }
         }
@@ -112,89 +111,83 @@ vector<vector<int>> DPSolver::singleStep(const vector<vector<int>>& clauseSet) {
     }
 
     bool DPSolver::solve() {
-    cout << "[DEBUG] Starting Davis-Putnam solver..." << endl;
+    LOG_DEBUG("Starting Davis-Putnam solver...");
+    interrupted = false;
 
     // Main solving loop
     while (!clauses.empty()) {
+        if (stopRequested()) return false;
+
         // Store initial state for comparison
         size_t clausesBefore = clauses.size();
 
         // Run unit propagation
         unitPropagation(assignment);
         if (checkEmptyClause()) {
-            cout << "[DEBUG] Empty clause found after unit propagation. UNSAT." << endl;
+            LOG_DEBUG("Empty clause found after unit propagation. UNSAT.");
             return false;
         }
         if (clauses.empty()) {
-            cout << "[DEBUG] All clauses satisfied after unit propagation. SAT." << endl;
+            LOG_DEBUG("All clauses satisfied after unit propagation. SAT.");
             return true;
         }
 
         // Run pure literal elimination
         eliminatePureLiterals(assignment);
         if (checkEmptyClause()) {
-            cout << "[DEBUG] Empty clause found after pure literal elimination. UNSAT." << endl;
+            LOG_DEBUG("Empty clause found after pure literal elimination. UNSAT.");
             return false;
         }
         if (clauses.empty()) {
-            cout << "[DEBUG] All clauses satisfied after pure literal elimination. SAT." << endl;
+            LOG_DEBUG("All clauses satisfied after pure literal elimination. SAT.");
             return true;
         }
 
         // If no changes from UP or PL, try resolution
         if (clauses.size() == clausesBefore) {
-            cout << "[DEBUG] No changes from UP or PL, attempting resolution step..." << endl;
+            LOG_DEBUG("No changes from UP or PL, attempting resolution step...");
             //copy current clauses
-            vector<vector<int>> f_clauses = clauses;
+            vector<CRef> f_clauses = clauses;
 
             // Perform single resolution step
             auto newClauses = singleStep(f_clauses);
 
             // If no new clauses were generated
             if (newClauses.size() == f_clauses.size()) {
-                cout << "[DEBUG] No new clauses from resolution. Formula is SAT." << endl;
+                LOG_DEBUG("No new clauses from resolution. Formula is SAT.");
                 return true;
             }
 
             // Update clauses with new resolvent
             clauses = newClauses;
-            cout << "[DEBUG] Resolution step added new clause(s). Continuing..." << endl;
+            LOG_DEBUG("Resolution step added new clause(s). Continuing...");
         }
 
         // Print current state
-        cout << "[DEBUG] Current clause count: " << clauses.size() << endl;
-        printClauses();
+        LOG_DEBUG("Current clause count: " << clauses.size());
+        if (LOG_ENABLED(TRACE)) {
+            for (CRef cr : clauses) LOG_TRACE(satlog::join(ca[cr]) << "0");
+        }
     }
         if (!clauses.empty()) {
-            cout << "[DEBUG] Making assignments for remaining variables..." << endl;
-
-            // Create a set of variables already assigned
-            set<int> assignedVars;
-            for (int lit : assignment) {
-                assignedVars.insert(abs(lit));
-            }
+            LOG_DEBUG("Making assignments for remaining variables...");
 
             // Handle remaining clauses
-            for (const auto& clause : clauses) {
+            for (CRef cr : clauses) {
                 // For each clause, assign its first literal if the variable isn't already assigned
-                for (int lit : clause) {
-                    int var = abs(lit);
-                    if (assignedVars.find(var) == assignedVars.end()) {
+                for (int lit : ca[cr]) {
+                    if (literalValue(lit) == 0) {
                         assignment.push_back(lit);  // Add the literal (not just the variable)
-                        assignedVars.insert(var);
+                        assignValue(lit);
                         break;
                     }
                 }
             }
 
-            cout << "[DEBUG] Final assignment after handling remaining clauses: ";
-            for (int lit : assignment) {
-                cout << lit << " ";
-            }
-            cout << endl;
+            LOG_DEBUG("Final assignment after handling remaining clauses: " << satlog::join(assignment));
         }
 
-        cout << "[DEBUG] All clauses processed. Formula is SAT." << endl;
+        LOG_DEBUG("All clauses processed. Formula is SAT.");
         return true;
 
 }
@@ -209,23 +202,28 @@ bool DPSolver::verifySolution(const vector<int>& assignment, const vector<vector
     }
     cout << endl;
 
+    // Dense lookup table: value[var] is 1 or -1 for assigned variables
+    vector<signed char> value(numVars + 1, 0);
+    for (int lit : assignment) {
+        size_t var = abs(lit);
+        if (var >= value.size()) value.resize(var + 1, 0);
+        value[var] = (lit > 0) ? 1 : -1;
+    }
+
     for (const auto& clause : originalClauses) {
-        cout << "Checking clause: ";
-        for (int lit : clause) {
-            cout << lit << " ";
-        }
-        cout << endl;
+        LOG_TRACE("Checking clause: " << satlog::join(clause));
 
         bool clauseSatisfied = false;
         for (int literal : clause) {
-            if (find(assignment.begin(), assignment.end(), literal) != assignment.end()) {
-                cout << "Clause satisfied by literal: " << literal << endl;
+            size_t var = abs(literal);
+            if (var < value.size() && value[var] == (literal > 0 ? 1 : -1)) {
+                LOG_TRACE("Clause satisfied by literal: " << literal);
                 clauseSatisfied = true;
                 break;
             }
         }
         if (!clauseSatisfied) {
-            cout << "Clause not satisfied!" << endl;
+            LOG_ERROR("Clause not satisfied: " << satlog::join(clause) << "0");
             return false;
         }
     }
@@ -234,29 +232,30 @@ bool DPSolver::verifySolution(const vector<int>& assignment, const vector<vector
 
 void DPSolver::addToAssignment(int literal) {
     assignment.push_back(literal);
+    assignValue(literal);
     
-    // Create a new vector for updated clauses
-    vector<vector<int>> newClauses;
-    
-    for (const auto& clause : clauses) {
+    // Drop satisfied clauses and shrink the others in place
+    size_t j = 0;
+    for (size_t i = 0; i < clauses.size(); i++) {
+        Clause clause = ca[clauses[i]];
+
         // If clause contains the literal, it's satisfied
-        if (find(clause.begin(), clause.end(), literal) != clause.end()) {
+        if (clause.contains(literal)) {
+            ca.free(clauses[i]);
             continue;
         }
         
         // If clause contains the negation, remove just that literal
-        vector<int> newClause;
-        for (int lit : clause) {
-            if (lit != -literal) {
-                newClause.push_back(lit);
-            }
-        }
+        ca.removeLiteral(clauses[i], -literal);
         
-        // Only add non-empty clauses
-        if (!newClause.empty()) {
-            newClauses.push_back(newClause);
+        // Only keep non-empty clauses
+        if (clause.size() > 0) {
+            clauses[j++] = clauses[i];
+        } else {
+            ca.free(clauses[i]);
         }
     }
     
-    clauses = newClauses;
+    clauses.resize(j);
+    checkGarbage();
 }
\ No newline at end of file
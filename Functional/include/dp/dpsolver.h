@@ -1,29 +1,19 @@
-#include "../parser/DIMACSParser.h"
 #include "../general/satsolver.h"
 
 class DPSolver : public SATSolver {
 private:
-    DIMACSParser parser;
-    vector<int> assignment;
     bool simplifyFormula(int literal);
     bool checkContradiction() const;
 
 
 public:
-    DPSolver(const string& filename) : SATSolver(filename), parser(filename) {}
-
-    int getNumLiterals() const {
-        return parser.getNumLiterals();
-    }
-
-    int getNumClauses() const {
-        return parser.getNumClauses();
-    }
+    DPSolver(const string& filename) : SATSolver(filename) {}
+    explicit DPSolver(shared_ptr<const Formula> formula) : SATSolver(move(formula)) {}
 
     vector<int> getAssignment() const ;
     void addToAssignment(int literal);
 
-    vector<vector<int>> singleStep(const vector<vector<int>>& clauseSet);
+    vector<CRef> singleStep(const vector<CRef>& clauseSet);
 
     bool verifySolution(const vector<int>& assignment, const vector<vector<int>>& originalClauses);
 
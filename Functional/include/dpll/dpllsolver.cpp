@@ -1,17 +1,24 @@
 #include "./dpllsolver.h"
 #include <iostream>
-#include <map>
 #include <algorithm>
+#include <cmath>
+#include "../general/log.h"
 using namespace std;
 
 DPLLSolver::DPLLSolver(const string& filename) : SATSolver(filename) {}
 
+DPLLSolver::DPLLSolver(shared_ptr<const Formula> formula) : SATSolver(move(formula)) {}
+
 bool DPLLSolver::solve() {
     cout << "Solving using DPLL..." << endl;
-    vector<int> assignment;
-    bool result = dpllRecursive(assignment);
-    if (result) {
-        finalAssignment = assignment;
+
+    bool result = startSearch(vector<int>()) && dpllSearch();
+    satlog::flush();
+    if (interrupted) {
+        cout << "UNKNOWN" << endl;
+        result = false;
+    } else if (result) {
+        finalAssignment = completeModel();
         cout << "SATISFIABLE" << endl;
         printAssignment(finalAssignment);
     } else {
@@ -24,106 +31,477 @@ std::vector<int> DPLLSolver::getAssignment() const {
     return finalAssignment;
 }
 
-bool DPLLSolver::dpllRecursive(vector<int>& assignment) {
-    bool changed;
-    do {
-        changed = false;
-        
-        // Store size before unit propagation
-        size_t beforeUP = assignment.size();
-        unitPropagation(assignment);  // Using SATSolver's implementation
-        if (checkEmptyClause()) {
-            cout << "[DEBUG] Empty clause found after unit propagation" << endl;
-            return false;
+SolveResult DPLLSolver::solveCube(const vector<int>& cube) {
+    finalAssignment.clear();
+    bool result = startSearch(cube) && dpllSearch();
+    if (interrupted) return SolveResult::Unknown;
+    if (!result) return SolveResult::Unsat;
+    finalAssignment = completeModel();
+    return SolveResult::Sat;
+}
+
+SolveResult DPLLSolver::makeCubes(const vector<int>& prefix, int depth, vector<vector<int>>& cubes) {
+    finalAssignment.clear();
+    cubes.clear();
+    if (!startSearch(prefix)) return SolveResult::Unsat;
+    return splitBelow(depth, cubes) ? SolveResult::Sat : (cubes.empty() ? SolveResult::Unsat : SolveResult::Unknown);
+}
+
+// Resets the search state and takes the cube literals as decisions that
+// are never flipped; false if propagation refutes the cube
+bool DPLLSolver::startSearch(const vector<int>& cube) {
+    interrupted = false;
+    restartPolicy.reset();
+    conflictsSinceRestart = 0;
+    restartGuard = RESTART_GUARD_START;
+    conflicts = 0;
+    decisions = 0;
+    branchFlipped.clear();
+    rootLevel = 0;
+
+    // The clause database is never rewritten during search, so level 0
+    // (the unit clauses, their consequences and the pure literals) comes
+    // out the same for every cube. After the first search only the levels
+    // above it are undone, which makes a new cube cost no more than
+    // propagating its own literals.
+    if (levelZeroReady) {
+        if (decisionLevel() > 0) {
+            unwindCounters(trailLim[0]);
+            backtrack(0);
         }
-        changed |= (assignment.size() > beforeUP);
-        
-        // Store size before pure literal elimination
-        size_t beforePL = assignment.size();
-        eliminatePureLiterals(assignment);  // Using SATSolver's implementation
-        if (checkEmptyClause()) {
-            cout << "[DEBUG] Empty clause found after pure literal elimination" << endl;
-            return false;
+    } else {
+        clearAssignment();
+        initCounters();
+        if (heuristic == BranchHeuristic::VSIDS) {
+            initActivityOrder();
         }
-        changed |= (assignment.size() > beforePL);
-        
-    } while (changed);
+        // Unit clauses are assigned at level 0 while the watches are built
+        if (!initializeWatchedLiterals() || !propagateAll()) return false;
+        levelZeroReady = true;
+    }
 
-    // Check if all clauses are satisfied
-    if (clauses.empty()) {
-        cout << "[DEBUG] All clauses satisfied" << endl;
-        return true;
+    // Literals the cube implies already take no level of their own
+    for (int literal : cube) {
+        if (!propagateAll()) return false;
+        int value = literalValue(literal);
+        if (value < 0) return false;
+        if (value > 0) continue;
+        newDecisionLevel();
+        branchFlipped.push_back(true);
+        addToAssignment(literal);
     }
+    rootLevel = decisionLevel();
+    return true;
+}
 
-    // Choose next literal (we can improve this later)
-    int literal = chooseLiteral(assignment);
-    if (literal == 0) {
-        cout << "[DEBUG] No literal to choose" << endl;
+// Unit propagation and pure literals until nothing changes; false on a conflict
+bool DPLLSolver::propagateAll() {
+    do {
+        if (propagate() != CREF_UNDEF) return false;
+    } while (assignPureLiterals());
+    return true;
+}
+
+// Both branches of the next depth decisions below the current trail,
+// depth first. Leaves become cubes (the decision literals of the trail);
+// true if a branch satisfied the formula, which is then in finalAssignment.
+bool DPLLSolver::splitBelow(int depth, vector<vector<int>>& cubes) {
+    if (!propagateAll()) return false;
+    if (depth == 0) {
+        vector<int> cube;
+        for (size_t start : trailLim) cube.push_back(assignment[start]);
+        cubes.push_back(cube);
         return false;
     }
+    int literal = chooseLiteral();
+    if (literal == 0) {
+        finalAssignment = completeModel();
+        return true;
+    }
+    for (int branch : {literal, -literal}) {
+        int level = decisionLevel();
+        newDecisionLevel();
+        addToAssignment(branch);
+        if (splitBelow(depth - 1, cubes)) return true;
+        unwindCounters(trailLim[level]);
+        backtrack(level);
+    }
+    return false;
+}
 
-    cout << "[DEBUG] Branching on literal: " << literal << endl;
+bool DPLLSolver::dpllSearch() {
+    // Depth-first search driven by the trail: level i starts with the
+    // decision at assignment[trailLim[i]] and branchFlipped[i] says whether
+    // that decision is already the second (negated) branch. startSearch()
+    // has set up the cube levels.
 
-    // Save current state
-    auto savedClauses = clauses;
-    auto savedAssignment = assignment;
-    
-    // Try positive literal
-    addToAssignment(literal);
-    if (dpllRecursive(assignment)) return true;
+    while (true) {
+        bool conflict = false;
+        bool changed;
+        do {
+            // Unit propagation through the watch lists
+            CRef conflictClause = propagate();
+            if (conflictClause != CREF_UNDEF) {
+                LOG_TRACE("Empty clause found after unit propagation");
+                if (heuristic == BranchHeuristic::VSIDS) {
+                    for (int lit : ca[conflictClause]) bumpActivity(abs(lit));
+                    decayActivity();
+                }
+                const Clause clause = ca[conflictClause];
+                restartPolicy.onConflict(computeLbd(clause.begin(), clause.size()));
+                conflictsSinceRestart++;
+                conflicts++;
+                conflict = true;
+                break;
+            }
 
-    // Restore state and try negative literal
-    clauses = savedClauses;
-    assignment = savedAssignment;
-    addToAssignment(-literal);
-    if (dpllRecursive(assignment)) return true;
+            // Pure literal elimination; new assignments may create new units
+            changed = assignPureLiterals();
+        } while (changed);
 
-    // If both branches failed, backtrack
-    assignment = savedAssignment;
-    clauses = savedClauses;
-    return false;
+        if (conflict) {
+            if (stopRequested()) return false;
+            if (decisionLevel() > rootLevel && conflictsSinceRestart >= restartGuard && restartPolicy.shouldRestart()) {
+                restart();
+                continue;
+            }
+
+            // Undo levels whose both branches failed, then flip the most
+            // recent decision that still has its second branch open; the
+            // cube levels below rootLevel are never flipped
+            int literal = 0;
+            while (decisionLevel() > rootLevel) {
+                int level = decisionLevel() - 1;
+                int decision = assignment[trailLim[level]];
+                bool flipped = branchFlipped[level];
+                unwindCounters(trailLim[level]);
+                backtrack(level);
+                branchFlipped.pop_back();
+                if (!flipped) {
+                    literal = -decision;
+                    break;
+                }
+            }
+            if (literal == 0) {
+                return false;  // both branches of every decision failed
+            }
+
+            newDecisionLevel();
+            branchFlipped.push_back(true);
+            addToAssignment(literal);
+            continue;
+        }
+
+        if (exportWanted && exportWanted()) exportOpenBranch();
+
+        // Choose next literal (we can improve this later)
+        int literal = chooseLiteral();
+        if (literal == 0) {
+            // No unassigned literal left in an unsatisfied clause
+            LOG_DEBUG("All clauses satisfied");
+            return true;
+        }
+
+        LOG_TRACE("Branching on literal: " << literal);
+
+        // Try the chosen polarity first
+        decisions++;
+        newDecisionLevel();
+        branchFlipped.push_back(false);
+        addToAssignment(literal);
+    }
 }
 
-int DPLLSolver::chooseLiteral(const std::vector<int>& currentAssignment) const {
-    // Create a map to store literal frequencies
-    std::map<int, int> literalFreq;
-    
-    // Count frequencies of literals in active clauses
-    for (const auto& clause : clauses) {
+// The lowest open level roots the largest untried subtree: its cube is
+// the decisions below it followed by the negated decision. No level up
+// to that one has a branch left to try, so what remains of this search
+// lies below all of them: they join the root levels, and a restart no
+// longer goes back far enough to search the given branch again.
+void DPLLSolver::exportOpenBranch() {
+    for (int level = rootLevel; level < decisionLevel(); level++) {
+        if (branchFlipped[level]) continue;
+        vector<int> cube;
+        for (int below = 0; below < level; below++) cube.push_back(assignment[trailLim[below]]);
+        cube.push_back(-assignment[trailLim[level]]);
+        branchFlipped[level] = true;
+        rootLevel = level + 1;
+        exportBranch(cube);
+        return;
+    }
+}
+
+// The search stops once no clause is left unsatisfied, which can leave
+// variables unassigned; tautologies count as satisfied from the start, so
+// their variables may be among them. Each gets a value here, so the model
+// satisfies every clause as written.
+vector<int> DPLLSolver::completeModel() const {
+    vector<int> model = assignment;
+    for (int var = 1; var <= numVars; var++) {
+        if (values[var] == 0) model.push_back(pickPhase(var, -var));
+    }
+    return model;
+}
+
+void DPLLSolver::restart() {
+    LOG_DEBUG("Restarting after " << conflictsSinceRestart << " conflicts");
+    unwindCounters(trailLim[rootLevel]);
+    backtrack(rootLevel);
+    branchFlipped.resize(rootLevel);
+    restartPolicy.onRestart();
+    resetTargetPhase();
+    conflictsSinceRestart = 0;
+    restartGuard *= RESTART_GUARD_GROWTH;
+}
+
+void DPLLSolver::initCounters() {
+    size_t numLits = 2 * (numVars + 1);
+    occurs.assign(numLits, {});
+    occCount.assign(numLits, 0);
+    jwScore.assign(numLits, 0.0);
+    momsCount.assign(numLits * (MOMS_MAX_SIZE - 1), 0);
+    countedValue.assign(numVars + 1, 0);
+    countedHead = 0;
+    trueCount.assign(clauses.size(), 0);
+    freeCount.assign(clauses.size(), 0);
+    unsatCount = 0;
+
+    size_t maxSize = 0;
+    for (size_t i = 0; i < clauses.size(); i++) {
+        Clause clause = ca[clauses[i]];
+
+        // Repeated literals would be counted twice; drop them here
+        uint32_t kept = 0;
+        for (uint32_t j = 0; j < clause.size(); j++) {
+            uint32_t k = 0;
+            while (k < kept && clause[k] != clause[j]) k++;
+            if (k == kept) clause[kept++] = clause[j];
+        }
+        ca.shrink(clauses[i], kept);
+
         for (int lit : clause) {
-            // Skip if this literal is already assigned
-            if (std::find(currentAssignment.begin(), currentAssignment.end(), lit) != currentAssignment.end() ||
-                std::find(currentAssignment.begin(), currentAssignment.end(), -lit) != currentAssignment.end()) {
-                continue;
-            }
-            literalFreq[lit]++;
+            occurs[litIndex(lit)].push_back(i);
+            // A tautology is satisfied whatever the assignment: it starts
+            // with one true literal more than it has, so it is never counted
+            if (clause.contains(-lit) && lit > 0) trueCount[i]++;
         }
+        freeCount[i] = static_cast<int>(clause.size());
+        maxSize = max(maxSize, static_cast<size_t>(clause.size()));
     }
-    
-    if (literalFreq.empty()) {
-        return 0;  // No unassigned literals found
+
+    jwWeights.resize(maxSize + 1);
+    for (size_t k = 0; k <= maxSize; k++) jwWeights[k] = ldexp(1.0, -static_cast<int>(k));
+    sizeCount.assign(maxSize + 1, 0);
+    for (size_t i = 0; i < clauses.size(); i++) {
+        if (trueCount[i] == 0) updateClauseScores(i, 1);
+    }
+
+    // Every variable is checked for purity once; afterwards only the ones
+    // whose counters reach zero or that get unassigned
+    pureCandidates.clear();
+    pureQueued.assign(numVars + 1, 0);
+    for (int var = numVars; var >= 1; var--) queuePureCandidate(var);
+}
+
+void DPLLSolver::updateClauseScores(size_t index, int sign) {
+    const Clause clause = ca[clauses[index]];
+    int size = freeCount[index];
+    sizeCount[size] += sign;
+    unsatCount += sign;
+    double weight = sign * jwWeights[size];
+
+    for (int lit : clause) {
+        if (countedValue[abs(lit)] != 0) continue;
+        size_t idx = litIndex(lit);
+        occCount[idx] += sign;
+        jwScore[idx] += weight;
+        if (size >= 2 && size <= MOMS_MAX_SIZE) {
+            momsCount[idx * (MOMS_MAX_SIZE - 1) + (size - 2)] += sign;
+        }
+        if (occCount[idx] == 0) queuePureCandidate(abs(lit));
     }
-    
-    // Find the literal with maximum frequency
+}
+
+void DPLLSolver::countAssigned(int literal) {
+    const vector<size_t>& satisfied = occurs[litIndex(literal)];
+    const vector<size_t>& shrunk = occurs[litIndex(-literal)];
+
+    // Take the clauses out with their old size, then put the ones that are
+    // still unsatisfied back with the literal gone
+    for (size_t i : satisfied) {
+        if (trueCount[i] == 0) updateClauseScores(i, -1);
+    }
+    for (size_t i : shrunk) {
+        if (trueCount[i] == 0) updateClauseScores(i, -1);
+    }
+    countedValue[abs(literal)] = literal > 0 ? 1 : -1;
+    for (size_t i : satisfied) {
+        trueCount[i]++;
+        freeCount[i]--;
+    }
+    for (size_t i : shrunk) {
+        freeCount[i]--;
+        if (trueCount[i] == 0) updateClauseScores(i, 1);
+    }
+}
+
+void DPLLSolver::countUnassigned(int literal) {
+    const vector<size_t>& satisfied = occurs[litIndex(literal)];
+    const vector<size_t>& shrunk = occurs[litIndex(-literal)];
+
+    // Exact inverse of countAssigned()
+    for (size_t i : shrunk) {
+        if (trueCount[i] == 0) updateClauseScores(i, -1);
+    }
+    countedValue[abs(literal)] = 0;
+    for (size_t i : satisfied) {
+        trueCount[i]--;
+        freeCount[i]++;
+    }
+    for (size_t i : shrunk) freeCount[i]++;
+    for (size_t i : satisfied) {
+        if (trueCount[i] == 0) updateClauseScores(i, 1);
+    }
+    for (size_t i : shrunk) {
+        if (trueCount[i] == 0) updateClauseScores(i, 1);
+    }
+    queuePureCandidate(abs(literal));
+}
+
+void DPLLSolver::syncCounters() {
+    while (countedHead < assignment.size()) {
+        countAssigned(assignment[countedHead++]);
+    }
+}
+
+void DPLLSolver::unwindCounters(size_t trailSize) {
+    while (countedHead > trailSize) {
+        countUnassigned(assignment[--countedHead]);
+    }
+}
+
+void DPLLSolver::queuePureCandidate(int var) {
+    if (pureQueued[var]) return;
+    pureQueued[var] = 1;
+    pureCandidates.push_back(var);
+}
+
+bool DPLLSolver::assignPureLiterals() {
+    // A variable can only become pure when one of its counters drops to
+    // zero or when it is unassigned, so only those variables are checked
+    bool assigned = false;
+    syncCounters();
+    while (!pureCandidates.empty()) {
+        int var = pureCandidates.back();
+        pureCandidates.pop_back();
+        pureQueued[var] = 0;
+        if (values[var] != 0) continue;
+
+        int positive = occCount[litIndex(var)];
+        int negative = occCount[litIndex(-var)];
+        if (positive > 0 && negative == 0) {
+            LOG_TRACE("Pure positive literal found: " << var);
+            addToAssignment(var);
+        } else if (negative > 0 && positive == 0) {
+            LOG_TRACE("Pure negative literal found: " << -var);
+            addToAssignment(-var);
+        } else {
+            continue;
+        }
+        syncCounters();
+        assigned = true;
+    }
+    return assigned;
+}
+
+int DPLLSolver::chooseLiteral() {
+    // No unsatisfied clause left: the formula is satisfied
+    syncCounters();
+    if (unsatCount == 0) return 0;
+
+    int literal;
+    switch (heuristic) {
+    case BranchHeuristic::VSIDS:
+        // Most active unassigned variable, O(log n) from the heap
+        literal = -pickActivityVariable();
+        break;
+    case BranchHeuristic::MOMs:
+        literal = chooseMOMsLiteral();
+        break;
+    case BranchHeuristic::JeroslowWang:
+        literal = chooseJeroslowWangLiteral();
+        break;
+    default:
+        literal = chooseMaxFrequencyLiteral();
+        break;
+    }
+
+    // The heuristic picks the variable; a saved or target phase, when the
+    // variable has one, overrides the polarity it proposed
+    if (literal == 0) return 0;
+    return pickPhase(abs(literal), literal);
+}
+
+// The choosers below read the counters of the unassigned variables only;
+// the clauses themselves are not visited.
+
+int DPLLSolver::chooseMaxFrequencyLiteral() const {
     int maxFreq = 0;
     int chosenLiteral = 0;
-    
-    for (const auto& pair : literalFreq) {
-        int lit = pair.first;
-        int freq = pair.second;
+    for (int var = 1; var <= numVars; var++) {
+        if (values[var] != 0) continue;
+        int freq = occCount[litIndex(var)];
+        int negFreq = occCount[litIndex(-var)];
         // Consider both positive and negative occurrences
-        int totalFreq = freq;
-        if (literalFreq.find(-lit) != literalFreq.end()) {
-            totalFreq += literalFreq.at(-lit);
-        }
-        
-        if (totalFreq > maxFreq) {
-            maxFreq = totalFreq;
+        if (freq + negFreq > maxFreq) {
+            maxFreq = freq + negFreq;
             // Choose the form (positive/negative) that appears more frequently
-            chosenLiteral = (freq >= literalFreq[-lit]) ? lit : -lit;
+            chosenLiteral = (freq >= negFreq) ? var : -var;
+        }
+    }
+    return chosenLiteral;
+}
+
+int DPLLSolver::chooseMOMsLiteral() const {
+    // Shortest size among the unsatisfied clauses; after propagation no
+    // unsatisfied clause has fewer than two unassigned literals
+    int limit = static_cast<int>(sizeCount.size()) - 1;
+    if (limit > MOMS_MAX_SIZE) limit = MOMS_MAX_SIZE;
+    int size = 2;
+    while (size <= limit && sizeCount[size] == 0) size++;
+    if (size > limit) {
+        // Only long clauses are left; plain occurrence counts will do
+        return chooseMaxFrequencyLiteral();
+    }
+
+    long long maxScore = -1;
+    int chosenLiteral = 0;
+    for (int var = 1; var <= numVars; var++) {
+        if (values[var] != 0) continue;
+        long long pos = momsCount[litIndex(var) * (MOMS_MAX_SIZE - 1) + (size - 2)];
+        long long neg = momsCount[litIndex(-var) * (MOMS_MAX_SIZE - 1) + (size - 2)];
+        if (pos + neg == 0) continue;
+        long long score = ((pos + neg) << MOMS_WEIGHT) + pos * neg;
+        if (score > maxScore) {
+            maxScore = score;
+            chosenLiteral = (pos >= neg) ? var : -var;
+        }
+    }
+    return chosenLiteral;
+}
+
+int DPLLSolver::chooseJeroslowWangLiteral() const {
+    double maxScore = 0.0;
+    int chosenLiteral = 0;
+    for (int var = 1; var <= numVars; var++) {
+        if (values[var] != 0) continue;
+        double pos = jwScore[litIndex(var)];
+        double neg = jwScore[litIndex(-var)];
+        if (occCount[litIndex(var)] + occCount[litIndex(-var)] == 0) continue;
+        if (chosenLiteral == 0 || pos + neg > maxScore) {
+            maxScore = pos + neg;
+            chosenLiteral = (pos >= neg) ? var : -var;
         }
     }
-    
     return chosenLiteral;
 }
 
@@ -134,35 +512,8 @@ void DPLLSolver::printAssignment(const vector<int>& assignment) const {
 }
 
 void DPLLSolver::addToAssignment(int literal) {
-    // Add the literal to the assignment
+    // Record the literal on the trail; clauses are left untouched and the
+    // assignment is undone by backtrack()
+    assignValue(literal);
     assignment.push_back(literal);
-    
-    // Create a new vector for updated clauses
-    vector<vector<int>> newClauses;
-    
-    for (const auto& clause : clauses) {
-        // Check if clause is satisfied by the literal
-        bool isSatisfied = false;
-        vector<int> newClause;
-        
-        for (int lit : clause) {
-            if (lit == literal) {
-                // Clause is satisfied by this literal, skip it
-                isSatisfied = true;
-                break;
-            }
-            if (lit != -literal) {
-                // Keep literals that aren't the negation of our assignment
-                newClause.push_back(lit);
-            }
-        }
-        
-        // Only add non-satisfied and non-empty clauses
-        if (!isSatisfied && !newClause.empty()) {
-            newClauses.push_back(newClause);
-        }
-    }
-    
-    // Update clauses
-    clauses = newClauses;
-}
\ No newline at end of file
+}
@@ -1,11 +1,29 @@
+#ifndef DPLLSOLVER_H
+#define DPLLSOLVER_H
+
 #include "../general/satsolver.h"
 #include <vector>
 #include <set>
 #include <string>
+#include <functional>
+
+// Decision heuristics available to the DPLL engine
+enum class BranchHeuristic {
+    MaxFrequency,  // most frequent literal in the unsatisfied clauses
+    MOMs,          // maximum occurrences in the shortest unsatisfied clauses
+    JeroslowWang,  // two-sided Jeroslow-Wang, clauses weighted by 2^-size
+    VSIDS          // activity bumped on conflicts, kept in a binary heap
+};
 
 class DPLLSolver : public SATSolver {
 public:
     DPLLSolver(const std::string& filename);
+    explicit DPLLSolver(std::shared_ptr<const Formula> formula);
+
+    void setHeuristic(BranchHeuristic h) {
+        heuristic = h;
+        levelZeroReady = false;
+    }
 
     // Returns true if SAT, false if UNSAT
     bool solve();
@@ -13,16 +31,98 @@ public:
     // Returns the satisfying assignment (if any)
     std::vector<int> getAssignment() const;
 
-    // Override base class method
+    // Cube interface for distributed search. A cube is a list of literals
+    // taken as decisions that are never flipped. solveCube() searches
+    // quietly below the cube only: Unsat means no model extends it, Sat
+    // leaves the model in getAssignment(). makeCubes() splits the subtree
+    // below prefix along the next depth decisions of chooseLiteral() (both
+    // polarities) into cubes that start with prefix; branches refuted by
+    // propagation are left out. It returns Unknown with the cubes, Unsat if
+    // every branch was refuted, or Sat if a branch satisfied the formula.
+    SolveResult solveCube(const std::vector<int>& cube);
+    SolveResult makeCubes(const std::vector<int>& prefix, int depth, std::vector<std::vector<int>>& cubes);
+
+    // Work sharing. wanted() is asked before every decision; when it
+    // returns true, the untried second branch of the lowest open decision
+    // level is passed to give() as a cube and left out of this search for
+    // good (restarts never go back above it), so no work is lost or
+    // repeated.
+    void setBranchExport(std::function<bool()> wanted, std::function<void(const std::vector<int>&)> give) {
+        exportWanted = std::move(wanted);
+        exportBranch = std::move(give);
+    }
+
+    // Statistics of the last solve()
+    uint64_t getConflicts() const { return conflicts; }
+    uint64_t getDecisions() const { return decisions; }
+
+    // Override base class method: pushes the literal onto the trail
     void addToAssignment(int literal) override;
 
 private:
-    bool dpllRecursive(std::vector<int>& assignment);
-    int chooseLiteral(const std::vector<int>& currentAssignment) const;
+    bool startSearch(const std::vector<int>& cube);
+    bool propagateAll();
+    bool splitBelow(int depth, std::vector<std::vector<int>>& cubes);
+    bool dpllSearch();
+    void exportOpenBranch();
+    std::vector<int> completeModel() const;  // the trail, plus a value for every unassigned variable
+    int chooseLiteral();
+    int chooseMaxFrequencyLiteral() const;
+    int chooseMOMsLiteral() const;
+    int chooseJeroslowWangLiteral() const;
     void printAssignment(const std::vector<int>& assignment) const;
-    bool isClauseSatisfied(const std::vector<int>& clause, const std::vector<int>& currentAssignment) const;
-    void updateClauses(const std::vector<int>& currentAssignment);
 
+    bool assignPureLiterals();  // true if anything was assigned
+
+    // Occurrence counters. They describe the formula under the trail prefix
+    // assignment[0, countedHead): for every unassigned literal, how often it
+    // occurs in the clauses not yet satisfied, also weighted by clause size
+    // (Jeroslow-Wang) and split by size for the short clauses (MOMs). They
+    // are moved forward along the trail by syncCounters() and back by
+    // unwindCounters(), touching only the clauses of the variable involved.
+    void initCounters();
+    void syncCounters();
+    void unwindCounters(size_t trailSize);
+    void countAssigned(int literal);
+    void countUnassigned(int literal);
+    void updateClauseScores(size_t index, int sign);  // add (+1) or remove (-1) a clause
+    void queuePureCandidate(int var);
+
+    static const int MOMS_MAX_SIZE = 4;  // clause sizes 2..MOMS_MAX_SIZE are tracked for MOMs
+    static const int MOMS_WEIGHT = 10;   // MOMs score: (f(x) + f(-x)) * 2^MOMS_WEIGHT + f(x) * f(-x)
+
+    // Without learnt clauses a restart can only redo work, so DPLL never
+    // restarts before restartGuard conflicts; the guard grows after every
+    // restart, which keeps the search complete whatever the policy says
+    void restart();
+    uint64_t conflictsSinceRestart = 0;
+    double restartGuard = 0.0;
+    static constexpr double RESTART_GUARD_START = 100.0;
+    static constexpr double RESTART_GUARD_GROWTH = 1.1;
+
+    BranchHeuristic heuristic = BranchHeuristic::MaxFrequency;
+    uint64_t conflicts = 0;
+    uint64_t decisions = 0;
     std::vector<int> finalAssignment;
-    std::vector<std::vector<int>> originalClauses;  // Store original clauses for verification
-};
\ No newline at end of file
+    std::vector<bool> branchFlipped;           // per decision level
+    int rootLevel = 0;                         // levels never undone: the cube's, then those of given branches
+    bool levelZeroReady = false;               // counters, watches and level 0 kept from the last search
+    std::function<bool()> exportWanted;
+    std::function<void(const std::vector<int>&)> exportBranch;
+
+    std::vector<std::vector<size_t>> occurs;   // clause indices per literal (litIndex)
+    std::vector<int> trueCount;                // true literals per clause
+    std::vector<int> freeCount;                // unassigned literals per clause
+    std::vector<signed char> countedValue;     // values as seen by the counters
+    size_t countedHead = 0;
+    std::vector<int> occCount;                 // per literal, unsatisfied clauses only
+    std::vector<double> jwScore;               // per literal, sum of 2^-size
+    std::vector<int> momsCount;                // per literal and tracked clause size
+    std::vector<double> jwWeights;             // 2^-size by size
+    std::vector<int> sizeCount;                // unsatisfied clauses by number of unassigned literals
+    size_t unsatCount = 0;
+    std::vector<int> pureCandidates;           // variables that may have become pure
+    std::vector<unsigned char> pureQueued;
+};
+
+#endif // DPLLSOLVER_H
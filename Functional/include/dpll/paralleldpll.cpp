@@ -0,0 +1,111 @@
+#include "./paralleldpll.h"
+#include "../general/threadpool.h"
+#include "../general/log.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+using namespace std;
+
+namespace {
+
+// The caller's stop callback is asked only every this many calls; the
+// finished flag on every call
+const unsigned POLL_INTERVAL = 64;
+
+} // namespace
+
+ParallelDPLLResult runParallelDPLL(shared_ptr<const Formula> formula, unsigned threads, BranchHeuristic heuristic,
+                                   function<bool()> stop) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+
+    ParallelDPLLResult result;
+    mutex lock;                          // guards result and everything down to waiting
+    condition_variable changed;          // a cube was queued, or the search is over
+    deque<vector<int>> queue = {{}};     // cubes nobody has taken yet, the whole formula first
+    size_t open = 1;                     // cubes queued or being searched
+    unsigned waiting = 0;                // threads looking for a cube
+    bool incomplete = false;             // a cube ended without an answer
+    atomic<bool> finished{false};
+    atomic<int> demand{0};               // waiting threads not matched by a queued cube
+    auto updateDemand = [&]() {
+        demand.store(static_cast<int>(waiting) - static_cast<int>(queue.size()), memory_order_relaxed);
+    };
+
+    {
+        ThreadPool pool(threads);
+        for (unsigned i = 0; i < threads; i++) {
+            pool.submit([&]() {
+                DPLLSolver solver(formula);
+                solver.setHeuristic(heuristic);
+                unsigned polls = 0;
+                solver.setTerminate([&]() {
+                    if (finished.load(memory_order_relaxed)) return true;
+                    return ++polls % POLL_INTERVAL == 0 && stop && stop();
+                });
+                // Busy solvers read the demand without the lock; a branch
+                // given away after the demand was met just waits in the queue
+                solver.setBranchExport([&]() { return demand.load(memory_order_relaxed) > 0; },
+                                       [&](const vector<int>& branch) {
+                                           lock_guard<mutex> guard(lock);
+                                           queue.push_back(branch);
+                                           open++;
+                                           result.steals++;
+                                           updateDemand();
+                                           changed.notify_one();
+                                       });
+
+                while (true) {
+                    vector<int> cube;
+                    {
+                        unique_lock<mutex> guard(lock);
+                        waiting++;
+                        updateDemand();
+                        changed.wait(guard, [&]() { return !queue.empty() || open == 0 || finished.load(); });
+                        waiting--;
+                        if (open == 0 || finished.load()) {
+                            updateDemand();
+                            return;
+                        }
+                        cube = move(queue.front());
+                        queue.pop_front();
+                        updateDemand();
+                    }
+
+                    SolveResult outcome = solver.solveCube(cube);
+                    vector<int> model;
+                    if (outcome == SolveResult::Sat) {
+                        model = solver.getAssignment();
+                        if (!formula->isModel(model)) {
+                            LOG_ERROR("Parallel DPLL found an assignment that is not a model");
+                            outcome = SolveResult::Unknown;
+                        }
+                    }
+
+                    lock_guard<mutex> guard(lock);
+                    open--;
+                    result.conflicts += solver.getConflicts();
+                    result.decisions += solver.getDecisions();
+                    if (outcome != SolveResult::Unknown) result.subtrees++;
+                    if (outcome == SolveResult::Sat && result.status != SolveResult::Sat) {
+                        result.status = SolveResult::Sat;
+                        result.model = move(model);
+                        finished.store(true);
+                    } else if (outcome == SolveResult::Unknown) {
+                        incomplete = true;
+                        finished.store(true);
+                    }
+                    if (open == 0 || finished.load()) changed.notify_all();
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    if (result.status != SolveResult::Sat && !incomplete) result.status = SolveResult::Unsat;
+    LOG_DEBUG("Parallel DPLL on " << threads << " threads: " << result.subtrees << " subtrees searched, "
+                                  << result.steals << " branches stolen");
+    return result;
+}
@@ -0,0 +1,35 @@
+#ifndef PARALLELDPLL_H
+#define PARALLELDPLL_H
+
+#include "./dpllsolver.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <functional>
+
+struct ParallelDPLLResult {
+    SolveResult status = SolveResult::Unknown;
+    std::vector<int> model;  // after Sat
+    uint64_t subtrees = 0;   // cubes searched to the end, the first one included
+    uint64_t steals = 0;     // open branches handed to idle threads
+    uint64_t conflicts = 0;  // summed over the threads
+    uint64_t decisions = 0;
+};
+
+// One DPLL search split across threads (0 for all cores) by work
+// stealing. Every thread runs its own DPLLSolver on the shared formula;
+// the untried second branches on its trail are the work it could give
+// away. A thread that runs out of work announces it, and the next busy
+// solver to make a decision hands over its lowest open branch (the
+// biggest subtree it still owns) as a cube: the decisions above it and
+// the negated decision. The thief rebuilds the state from that prefix by
+// propagation alone, since its solver keeps level 0 between cubes.
+//
+// The answer is Sat as soon as any thread finds a model, which is checked
+// against every clause, and Unsat once every subtree has been refuted.
+// stop (may be empty) is polled from all threads at once.
+ParallelDPLLResult runParallelDPLL(std::shared_ptr<const Formula> formula, unsigned threads,
+                                   BranchHeuristic heuristic = BranchHeuristic::MaxFrequency,
+                                   std::function<bool()> stop = nullptr);
+
+#endif // PARALLELDPLL_H
@@ -0,0 +1,94 @@
+#include "./clausearena.h"
+#include <cstring>
+#include <stdexcept>
+
+float Clause::activity() const {
+    float activity;
+    memcpy(&activity, &data[2 + size()], sizeof(float));
+    return activity;
+}
+
+void Clause::setActivity(float activity) {
+    memcpy(&data[2 + size()], &activity, sizeof(float));
+}
+
+bool Clause::contains(int literal) const {
+    for (int lit : *this) {
+        if (lit == literal) return true;
+    }
+    return false;
+}
+
+CRef ClauseArena::alloc(const int* lits, size_t size, bool learnt) {
+    size_t words = clauseWords(size, learnt);
+    if (size > Clause::SIZE_MASK || memory.size() + words >= CREF_UNDEF) {
+        throw length_error("Clause arena exhausted");
+    }
+
+    CRef cr = static_cast<CRef>(memory.size());
+    memory.resize(memory.size() + words);
+    memory[cr] = static_cast<uint32_t>(size) | (learnt ? Clause::LEARNT_BIT : 0);
+    memcpy(&memory[cr + 1], lits, size * sizeof(int));
+    if (learnt) {
+        Clause c(&memory[cr]);
+        c.setLbd(0);
+        c.setActivity(0.0f);
+    }
+    return cr;
+}
+
+void ClauseArena::free(CRef cr) {
+    Clause c = (*this)[cr];
+    if (c.deleted()) return;
+    c.markDeleted();
+    wastedWords += clauseWords(c.size(), c.learnt());
+}
+
+// Drop the tail of the clause; learnt metadata moves down with it
+void ClauseArena::shrink(CRef cr, uint32_t newSize) {
+    uint32_t* data = &memory[cr];
+    Clause c(data);
+    uint32_t oldSize = c.size();
+    if (newSize >= oldSize) return;
+    if (c.learnt()) {
+        data[1 + newSize] = data[1 + oldSize];
+        data[2 + newSize] = data[2 + oldSize];
+    }
+    data[0] = (data[0] & ~Clause::SIZE_MASK) | newSize;
+    wastedWords += clauseWords(oldSize, c.learnt()) - clauseWords(newSize, c.learnt());
+}
+
+void ClauseArena::removeLiteral(CRef cr, int literal) {
+    Clause c = (*this)[cr];
+    uint32_t n = c.size();
+    uint32_t j = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (c[i] != literal) c[j++] = c[i];
+    }
+    if (j != n) shrink(cr, j);
+}
+
+void ClauseArena::relocate(CRef& cr, ClauseArena& to) {
+    Clause c = (*this)[cr];
+    if (c.reloced()) {
+        cr = c.relocation();
+        return;
+    }
+
+    CRef moved = to.alloc(c.begin(), c.size(), c.learnt());
+    if (c.learnt()) {
+        Clause copy = to[moved];
+        copy.setLbd(c.lbd());
+        copy.setUsed(c.used());
+        copy.setActivity(c.activity());
+    }
+    c.relocate(moved);
+    cr = moved;
+}
+
+void ClauseArena::moveTo(ClauseArena& to) {
+    to.memory.swap(memory);
+    to.wastedWords = wastedWords;
+    memory.clear();
+    wastedWords = 0;
+}
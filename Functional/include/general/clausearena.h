@@ -0,0 +1,103 @@
+#ifndef CLAUSEARENA_H
+#define CLAUSEARENA_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#pragma once
+
+using namespace std;
+
+// Clauses live in one contiguous block of 32-bit words and are referred to
+// by their offset (CRef). Layout of a clause:
+//
+//   [header][lit 0] ... [lit n-1]               original clause
+//   [header][lit 0] ... [lit n-1][lbd][activity] learnt clause
+//
+// The header packs the size and the learnt/deleted/relocated flags. Every
+// clause takes at least two words so that a relocated clause can keep its
+// new reference in place of its first literal.
+typedef uint32_t CRef;
+const CRef CREF_UNDEF = UINT32_MAX;
+
+class Clause {
+public:
+    explicit Clause(uint32_t* data) : data(data) {}
+
+    uint32_t size() const { return data[0] & SIZE_MASK; }
+    bool learnt() const { return (data[0] & LEARNT_BIT) != 0; }
+    bool deleted() const { return (data[0] & DELETED_BIT) != 0; }
+    void markDeleted() { data[0] |= DELETED_BIT; }
+    bool reloced() const { return (data[0] & RELOCED_BIT) != 0; }
+    CRef relocation() const { return data[1]; }
+    void relocate(CRef to) { data[0] |= RELOCED_BIT; data[1] = to; }
+
+    int& operator[](size_t i) { return lits()[i]; }
+    int operator[](size_t i) const { return lits()[i]; }
+    int* begin() { return lits(); }
+    int* end() { return lits() + size(); }
+    const int* begin() const { return lits(); }
+    const int* end() const { return lits() + size(); }
+
+    // Learnt clauses only. The used flag shares the LBD word and tells the
+    // clause database reduction that the clause took part in a conflict.
+    uint32_t lbd() const { return data[1 + size()] & ~USED_BIT; }
+    void setLbd(uint32_t lbd) { data[1 + size()] = (data[1 + size()] & USED_BIT) | lbd; }
+    bool used() const { return (data[1 + size()] & USED_BIT) != 0; }
+    void setUsed(bool used) { data[1 + size()] = lbd() | (used ? USED_BIT : 0); }
+    float activity() const;
+    void setActivity(float activity);
+
+    bool contains(int literal) const;
+
+    static const uint32_t SIZE_MASK = (1u << 29) - 1;
+    static const uint32_t LEARNT_BIT = 1u << 29;
+    static const uint32_t DELETED_BIT = 1u << 30;
+    static const uint32_t RELOCED_BIT = 1u << 31;
+    static const uint32_t USED_BIT = 1u << 31;  // in the LBD word
+
+private:
+    int* lits() { return reinterpret_cast<int*>(data + 1); }
+    const int* lits() const { return reinterpret_cast<const int*>(data + 1); }
+
+    uint32_t* data;
+};
+
+class ClauseArena {
+public:
+    CRef alloc(const int* lits, size_t size, bool learnt = false);
+    CRef alloc(const vector<int>& lits, bool learnt = false) { return alloc(lits.data(), lits.size(), learnt); }
+
+    Clause operator[](CRef cr) { return Clause(&memory[cr]); }
+    const Clause operator[](CRef cr) const { return Clause(const_cast<uint32_t*>(&memory[cr])); }
+
+    // Release a clause; its words are reclaimed by the next compaction
+    void free(CRef cr);
+
+    // Shorten a clause in place. The words it no longer uses count as
+    // wasted, like those of a freed clause, until the next compaction.
+    void shrink(CRef cr, uint32_t newSize);
+    void removeLiteral(CRef cr, int literal);  // keeps the order of the remaining literals
+
+    // Compaction: live clauses are copied to a fresh arena, each one once;
+    // relocate() updates a reference to point into the new arena, and
+    // moveTo() hands the new arena's memory over.
+    void relocate(CRef& cr, ClauseArena& to);
+    void moveTo(ClauseArena& to);
+
+    void reserve(size_t words) { memory.reserve(words); }
+    size_t size() const { return memory.size(); }
+    size_t wasted() const { return wastedWords; }
+    size_t bytes() const { return memory.capacity() * sizeof(uint32_t); }
+    void clear() { memory.clear(); wastedWords = 0; }
+
+    static size_t clauseWords(size_t size, bool learnt) { return max<size_t>(2, 1 + size + (learnt ? 2 : 0)); }
+
+private:
+    vector<uint32_t> memory;
+    size_t wastedWords = 0;
+};
+
+#endif // CLAUSEARENA_H
@@ -0,0 +1,139 @@
+#include "./clausesharing.h"
+#include <algorithm>
+
+namespace {
+
+// Credit saved up for imports is capped, so a long stretch without
+// restarts does not let a flood in at once
+const double CREDIT_ROUNDS = 4;
+
+// The LBD limit starts strict and loosens while rounds have room left
+const unsigned FIRST_LBD_LIMIT = 2;
+
+} // namespace
+
+ClauseBuffer::ClauseBuffer(const SharingLimits& limits)
+    : limits(limits), lbdLimit(min(FIRST_LBD_LIMIT, limits.maxLbd)) {}
+
+bool ClauseBuffer::add(const vector<int>& literals, unsigned lbd) {
+    if (literals.size() > limits.maxSize || lbd > lbdLimit) return false;
+    if (records.size() + literals.size() + 2 > limits.roundLiterals) {
+        overflowed = true;
+        return false;
+    }
+    records.push_back(static_cast<int>(literals.size()));
+    records.push_back(static_cast<int>(lbd));
+    records.insert(records.end(), literals.begin(), literals.end());
+    return true;
+}
+
+void ClauseBuffer::drain(vector<int>& out) {
+    if (overflowed) {
+        if (lbdLimit > 2) lbdLimit--;
+    } else if (records.size() < limits.roundLiterals / 2 && lbdLimit < limits.maxLbd) {
+        lbdLimit++;
+    }
+    overflowed = false;
+    out.insert(out.end(), records.begin(), records.end());
+    records.clear();
+}
+
+ClauseSharing::ClauseSharing(const SharingLimits& limits) : limits(limits), outgoing(limits) {}
+
+void ClauseSharing::exportClause(const vector<int>& literals, unsigned lbd) {
+    credit = min(credit + limits.importPerConflict, CREDIT_ROUNDS * static_cast<double>(limits.roundLiterals));
+    if (outgoing.add(literals, lbd)) exported++;
+}
+
+void ClauseSharing::importClauses(vector<SharedClause>& clauses) {
+    exchange();
+
+    // Record offsets, best first: lower LBD, then shorter
+    vector<size_t> offsets;
+    for (size_t i = 0; i + 1 < incoming.size(); i += incoming[i] + 2) offsets.push_back(i);
+    sort(offsets.begin(), offsets.end(), [this](size_t a, size_t b) {
+        if (incoming[a + 1] != incoming[b + 1]) return incoming[a + 1] < incoming[b + 1];
+        return incoming[a] < incoming[b];
+    });
+
+    for (size_t offset : offsets) {
+        size_t size = static_cast<size_t>(incoming[offset]);
+        if (credit < static_cast<double>(size)) {
+            dropped++;
+            continue;
+        }
+        credit -= static_cast<double>(size);
+        SharedClause clause;
+        clause.literals.assign(incoming.begin() + offset + 2, incoming.begin() + offset + 2 + size);
+        clause.lbd = static_cast<unsigned>(incoming[offset + 1]);
+        clauses.push_back(move(clause));
+        imported++;
+    }
+    incoming.clear();
+}
+
+ClauseRing::ClauseRing(size_t size) {
+    size_t capacity = 1;
+    while (capacity < size) capacity <<= 1;
+    slots = vector<atomic<int>>(capacity);
+    mask = capacity - 1;
+}
+
+// Announces the slots it is about to overwrite before touching them, so a
+// reader can tell afterwards whether what it copied was still intact
+void ClauseRing::write(const vector<int>& records) {
+    if (records.empty() || records.size() > slots.size()) return;
+    uint64_t start = head.load(memory_order_relaxed);
+    uint64_t end = start + records.size();
+    reserved.store(end, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (size_t i = 0; i < records.size(); i++) {
+        slots[(start + i) & mask].store(records[i], memory_order_relaxed);
+    }
+    head.store(end, memory_order_release);
+}
+
+void ClauseRing::read(uint64_t& position, vector<int>& records) const {
+    uint64_t end = head.load(memory_order_acquire);
+    if (end - position > slots.size()) {
+        position = end;  // overwritten already
+        return;
+    }
+    size_t start = records.size();
+    for (uint64_t i = position; i < end; i++) {
+        records.push_back(slots[i & mask].load(memory_order_relaxed));
+    }
+    atomic_thread_fence(memory_order_acquire);
+    if (reserved.load(memory_order_relaxed) - position > slots.size()) {
+        records.resize(start);  // the writer got there while we copied
+    }
+    position = end;
+}
+
+class ThreadClauseSharing::Endpoint : public ClauseSharing {
+public:
+    Endpoint(ThreadClauseSharing& group, unsigned index, const SharingLimits& limits)
+        : ClauseSharing(limits), group(group), index(index) {}
+
+protected:
+    void exchange() override {
+        records.clear();
+        outgoing.drain(records);
+        group.rings[index]->write(records);
+        positions.resize(group.rings.size(), 0);
+        for (size_t other = 0; other < group.rings.size(); other++) {
+            if (other != index) group.rings[other]->read(positions[other], incoming);
+        }
+    }
+
+private:
+    ThreadClauseSharing& group;
+    unsigned index;
+    vector<uint64_t> positions;  // read so far, per ring
+    vector<int> records;
+};
+
+ThreadClauseSharing::ThreadClauseSharing(unsigned solvers, const SharingLimits& limits, size_t ringSize) {
+    for (unsigned i = 0; i < solvers; i++) rings.push_back(make_unique<ClauseRing>(ringSize));
+    for (unsigned i = 0; i < solvers; i++) endpoints.push_back(make_unique<Endpoint>(*this, i, limits));
+}
@@ -0,0 +1,124 @@
+#ifndef CLAUSESHARING_H
+#define CLAUSESHARING_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#pragma once
+
+using namespace std;
+
+// A learnt clause on its way from one solver to another
+struct SharedClause {
+    vector<int> literals;
+    unsigned lbd = 0;
+};
+
+// What goes out and how much comes in
+struct SharingLimits {
+    size_t roundLiterals = 1500;   // literals a solver sends per round
+    size_t maxSize = 30;           // longer clauses are never sent
+    unsigned maxLbd = 8;           // bound of the adaptive LBD limit
+    double importPerConflict = 4;  // literals a solver takes per conflict of its own
+};
+
+// Clauses wait here for the next round, as records [size, lbd, literals...].
+// A clause is taken only while it fits and its LBD is within the limit.
+// After each round the limit moves between 2 and maxLbd: up when less
+// than half of the room was used, down when clauses had to be turned away,
+// so a round carries about roundLiterals literals whatever the solver's
+// conflict rate.
+class ClauseBuffer {
+public:
+    explicit ClauseBuffer(const SharingLimits& limits);
+
+    bool add(const vector<int>& literals, unsigned lbd);
+    void drain(vector<int>& records);  // appends the records, empties the buffer
+    unsigned getLbdLimit() const { return lbdLimit; }
+
+private:
+    SharingLimits limits;
+    vector<int> records;
+    unsigned lbdLimit;
+    bool overflowed = false;
+};
+
+// The end of a clause exchange that belongs to one solver, which calls it
+// from its own thread only: exportClause() with every clause it learns,
+// importClauses() whenever it is at decision level 0. The transport
+// (threads of one process, or MPI ranks) is up to the subclass.
+//
+// Imports are rationed by the importer's own progress: every clause it
+// exports earns importPerConflict literals of credit, and clauses beyond
+// the credit are dropped, worst LBD first. A slow solver is therefore never
+// flooded by faster ones, and a round that brings many clauses never holds
+// up the search for long.
+class ClauseSharing {
+public:
+    explicit ClauseSharing(const SharingLimits& limits = SharingLimits());
+    virtual ~ClauseSharing() = default;
+
+    void exportClause(const vector<int>& literals, unsigned lbd);
+    void importClauses(vector<SharedClause>& clauses);
+
+    uint64_t getExported() const { return exported; }
+    uint64_t getImported() const { return imported; }
+    uint64_t getDropped() const { return dropped; }
+
+protected:
+    // Sends what is waiting in outgoing and appends the records that came
+    // from other solvers to incoming
+    virtual void exchange() = 0;
+
+    SharingLimits limits;
+    ClauseBuffer outgoing;
+    vector<int> incoming;
+
+private:
+    double credit = 0;
+    uint64_t exported = 0;
+    uint64_t imported = 0;
+    uint64_t dropped = 0;
+};
+
+// Lock-free ring with one writer and any number of readers, each with its
+// own position. The writer never waits: a reader that falls more than the
+// ring size behind loses what was overwritten and starts again at the
+// newest record.
+class ClauseRing {
+public:
+    explicit ClauseRing(size_t size);  // rounded up to a power of two
+
+    void write(const vector<int>& records);
+    // Appends the records written since position, then moves position on
+    void read(uint64_t& position, vector<int>& records) const;
+
+private:
+    vector<atomic<int>> slots;
+    size_t mask;
+    atomic<uint64_t> head{0};      // end of the published records
+    atomic<uint64_t> reserved{0};  // end of the records being written
+};
+
+// Clause exchange between the solvers of one process, one per thread.
+// Every endpoint writes its rounds to its own ring and reads the rings of
+// all the others, so no thread ever takes a lock.
+class ThreadClauseSharing {
+public:
+    explicit ThreadClauseSharing(unsigned solvers, const SharingLimits& limits = SharingLimits(),
+                                 size_t ringSize = size_t(1) << 16);
+
+    // The endpoint of solver index; only that solver's thread may use it
+    ClauseSharing& endpoint(unsigned index) { return *endpoints[index]; }
+
+private:
+    class Endpoint;
+
+    vector<unique_ptr<ClauseRing>> rings;
+    vector<unique_ptr<ClauseSharing>> endpoints;
+};
+
+#endif // CLAUSESHARING_H
@@ -0,0 +1,118 @@
+#include "./formula.h"
+#include "../parser/DIMACSParser.h"
+#include "../parser/mappedfile.h"
+#include "../parser/snapshot.h"
+#include "./log.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+shared_ptr<const Formula> Formula::load(const string& filename, unsigned threads) {
+    LOG_DEBUG("Loading formula from file: " << filename);
+    unique_ptr<MappedFile> file;
+    try {
+        file = make_unique<MappedFile>(filename);
+    } catch (const runtime_error&) {
+        throw runtime_error("Failed to open DIMACS file: " + filename);
+    }
+    if (isSnapshot(file->data(), file->size())) return mapSnapshot(move(file));
+
+    DIMACSParser parser(file->data(), file->size(), threads);
+    return make_shared<const Formula>(parser.getNumLiterals(), parser.getNumClauses(), parser.releaseLiterals());
+}
+
+Formula::Formula(int numLiterals, int numClauses, vector<int> literals)
+    : numLiterals(numLiterals), numClauses(numClauses), numVars(numLiterals), storage(move(literals)) {
+    if (!storage.empty() && storage.back() != 0) storage.push_back(0);
+    for (int lit : storage) {
+        if (lit == 0) {
+            parsedClauses++;
+        } else {
+            numVars = max(numVars, abs(lit));
+        }
+    }
+    this->literals = storage;
+    hash = hashLiterals(this->literals);
+}
+
+Formula::~Formula() = default;
+
+// The literals stay in the mapping; only the header is read. The hash is
+// checked so a damaged file is not solved as a different formula, and the
+// sizes the hash does not cover are checked against the literals, since
+// the solvers size their per-variable arrays by numVars
+shared_ptr<const Formula> Formula::mapSnapshot(unique_ptr<MappedFile> file) {
+    const SnapshotHeader& header = readSnapshotHeader(file->data(), file->size());
+    const int* words = reinterpret_cast<const int*>(file->data() + sizeof(SnapshotHeader));
+    span<const int> literals(words, header.literalCount);
+    if (!literals.empty() && literals.back() != 0) {
+        throw runtime_error("Snapshot clause list does not end with a 0");
+    }
+    LiteralSummary summary = summarizeLiterals(literals);
+    if (summary.hash != header.hash) {
+        throw runtime_error("Snapshot content does not match its hash");
+    }
+    if (header.numLiterals < 0 || header.numClauses < 0 ||
+        header.numVars != max<int64_t>(header.numLiterals, summary.maxVar) ||
+        header.parsedClauses != summary.clauses) {
+        throw runtime_error("Snapshot header does not match its clauses");
+    }
+
+    shared_ptr<Formula> formula(new Formula());
+    formula->numLiterals = header.numLiterals;
+    formula->numClauses = header.numClauses;
+    formula->numVars = header.numVars;
+    formula->parsedClauses = header.parsedClauses;
+    formula->hash = header.hash;
+    formula->literals = literals;
+    formula->mapping = move(file);
+    LOG_DEBUG("Mapped snapshot: " << formula->numVars << " variables, " << formula->parsedClauses << " clauses");
+    return formula;
+}
+
+void Formula::saveSnapshot(const string& filename) const {
+    SnapshotHeader header{};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.numLiterals = numLiterals;
+    header.numClauses = numClauses;
+    header.numVars = numVars;
+    header.parsedClauses = parsedClauses;
+    header.literalCount = literals.size();
+    header.hash = hash;
+    writeSnapshot(filename, header, literals);
+}
+
+bool Formula::isModel(const vector<int>& model) const {
+    vector<signed char> value(numVars + 1, 0);
+    for (int lit : model) {
+        if (abs(lit) <= numVars) value[abs(lit)] = lit > 0 ? 1 : -1;
+    }
+    bool satisfied = false;
+    for (int lit : literals) {
+        if (lit == 0) {
+            if (!satisfied) return false;
+            satisfied = false;
+        } else if ((lit > 0 ? value[lit] : -value[-lit]) > 0) {
+            satisfied = true;
+        }
+    }
+    return true;
+}
+
+vector<vector<int>> Formula::getClauses() const {
+    vector<vector<int>> clauses;
+    clauses.reserve(parsedClauses);
+    vector<int> clause;
+    for (int lit : literals) {
+        if (lit == 0) {
+            clauses.push_back(clause);
+            clause.clear();
+        } else {
+            clause.push_back(lit);
+        }
+    }
+    return clauses;
+}
@@ -0,0 +1,65 @@
+#ifndef FORMULA_H
+#define FORMULA_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+#pragma once
+
+using namespace std;
+
+class MappedFile;
+
+// A parsed CNF formula. It never changes after construction, so one
+// instance can be shared by any number of solvers and threads through a
+// shared_ptr<const Formula>; each solver copies the clauses into its own
+// arena and never writes back.
+//
+// The literals live either in a buffer owned by the formula (parsed text)
+// or directly in a mapped snapshot file (see parser/snapshot.h).
+class Formula {
+public:
+    // Parses a DIMACS file (plain or compressed; threads as for
+    // DIMACSParser), or maps it if it is a snapshot written by saveSnapshot()
+    static shared_ptr<const Formula> load(const string& filename, unsigned threads = 0);
+
+    // numLiterals and numClauses are the problem line counts; literals holds
+    // the clauses back to back, each terminated by 0
+    Formula(int numLiterals, int numClauses, vector<int> literals);
+    ~Formula();
+
+    Formula(const Formula&) = delete;
+    Formula& operator=(const Formula&) = delete;
+
+    int getNumLiterals() const { return numLiterals; }
+    int getNumClauses() const { return numClauses; }
+    int getNumVars() const { return numVars; }  // header count or highest variable, if larger
+    size_t getNumParsedClauses() const { return parsedClauses; }
+    span<const int> getLiterals() const { return literals; }
+    vector<vector<int>> getClauses() const;
+    // True if the assignment (a list of literals) satisfies every clause;
+    // parallel solvers check answers with it before they count
+    bool isModel(const vector<int>& model) const;
+    uint64_t getHash() const { return hash; }  // identifies the clause list
+
+    void saveSnapshot(const string& filename) const;
+
+private:
+    Formula() = default;
+    static shared_ptr<const Formula> mapSnapshot(unique_ptr<MappedFile> file);
+
+    int numLiterals = 0;
+    int numClauses = 0;
+    int numVars = 0;
+    size_t parsedClauses = 0;
+    uint64_t hash = 0;
+    span<const int> literals;       // into storage or the mapped snapshot
+    vector<int> storage;
+    unique_ptr<MappedFile> mapping;
+};
+
+#endif // FORMULA_H
@@ -0,0 +1,89 @@
+#include "./log.h"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+namespace satlog {
+
+namespace {
+
+const size_t BUFFER_SIZE = 1 << 16;
+
+// Shared output buffer, written out when full and at exit
+struct Buffer {
+    std::mutex mutex;
+    std::string data;
+    FILE* out = stdout;
+
+    Buffer() { data.reserve(BUFFER_SIZE); }
+    ~Buffer() { write(); }
+
+    void write() {
+        if (!data.empty()) {
+            fwrite(data.data(), 1, data.size(), out);
+            fflush(out);
+            data.clear();
+        }
+    }
+};
+
+Buffer& buffer() {
+    static Buffer instance;
+    return instance;
+}
+
+int initialLevel() {
+    const char* env = getenv("SAT_LOG");
+    int level = env ? parseLevel(env) : -1;
+    return level >= 0 ? level : SAT_LOG_INFO;
+}
+
+} // namespace
+
+int runtimeLevel = initialLevel();
+
+void setLevel(int level) {
+    runtimeLevel = level;
+}
+
+int parseLevel(const char* name) {
+    static const char* names[] = {"none", "error", "info", "debug", "trace"};
+    for (int i = 0; i <= SAT_LOG_TRACE; i++) {
+        if (strcmp(name, names[i]) == 0) return i;
+    }
+    if (name[0] >= '0' && name[0] <= '0' + SAT_LOG_TRACE && name[1] == '\0') return name[0] - '0';
+    return -1;
+}
+
+void setOutput(FILE* out) {
+    Buffer& b = buffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.write();
+    b.out = out;
+}
+
+void flush() {
+    Buffer& b = buffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.write();
+}
+
+Line::Line(const char* tag) : out([]() -> std::ostringstream& {
+        thread_local std::ostringstream line;
+        return line;
+    }()) {
+    out.str(std::string());
+    out << tag;
+}
+
+Line::~Line() {
+    out << '\n';
+    const std::string& text = out.str();
+    Buffer& b = buffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.data += text;
+    if (b.data.size() >= BUFFER_SIZE) b.write();
+}
+
+} // namespace satlog
@@ -0,0 +1,127 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <sstream>
+#include <cstdio>
+#include <iterator>
+
+#pragma once
+
+// Leveled logging.
+//
+//   LOG_ERROR(...)  failures worth reporting even in quiet runs
+//   LOG_INFO(...)   one line per phase of a solve
+//   LOG_DEBUG(...)  one line per step (the old "[DEBUG]" output)
+//   LOG_TRACE(...)  per clause / per literal dumps
+//
+// The argument is a stream expression: LOG_DEBUG("unit " << lit).
+//
+// SAT_LOG_LEVEL (a compile definition, set by the CMake option of the same
+// name) is the highest level compiled in; statements above it generate no
+// code and their arguments are never evaluated. Below it the level is chosen at runtime with
+// satlog::setLevel() or the SAT_LOG environment variable (a number or one
+// of none/error/info/debug/trace); a disabled statement costs one compare.
+//
+// Enabled lines are collected in a buffer and written to stdout in large
+// blocks; satlog::flush() forces them out, e.g. before printing a result.
+
+#define SAT_LOG_NONE  0
+#define SAT_LOG_ERROR 1
+#define SAT_LOG_INFO  2
+#define SAT_LOG_DEBUG 3
+#define SAT_LOG_TRACE 4
+
+#ifndef SAT_LOG_LEVEL
+#define SAT_LOG_LEVEL SAT_LOG_DEBUG
+#endif
+
+namespace satlog {
+
+extern int runtimeLevel;
+
+inline bool enabled(int level) { return level <= runtimeLevel; }
+void setLevel(int level);
+int parseLevel(const char* name);  // -1 if unknown
+
+void setOutput(FILE* out);  // stdout by default
+void flush();
+
+// One log line: formatted in a per-thread stream, appended to the shared
+// buffer in one piece when it goes out of scope
+class Line {
+public:
+    explicit Line(const char* tag);
+    ~Line();
+    std::ostream& stream() { return out; }
+
+private:
+    std::ostringstream& out;
+};
+
+// Space separated elements of a container or range, for clause dumps
+template <typename Iterator>
+struct Joined {
+    Iterator first, last;
+};
+
+template <typename Iterator>
+Joined<Iterator> join(Iterator first, Iterator last) { return {first, last}; }
+
+template <typename Container>
+auto join(const Container& c) -> Joined<decltype(std::begin(c))> { return {std::begin(c), std::end(c)}; }
+
+template <typename Iterator>
+std::ostream& operator<<(std::ostream& os, const Joined<Iterator>& j) {
+    for (Iterator it = j.first; it != j.last; ++it) os << *it << " ";
+    return os;
+}
+
+} // namespace satlog
+
+#define SAT_LOG_AT(level, tag, msg) \
+    do { \
+        if (satlog::enabled(level)) { \
+            satlog::Line satLogLine_(tag); \
+            satLogLine_.stream() << msg; \
+        } \
+    } while (0)
+
+// Compiled-out statements keep their argument type-checked (so variables
+// used only for logging do not trigger warnings) but generate no code
+#define SAT_LOG_OFF(msg) \
+    do { \
+        if (false) { \
+            satlog::Line satLogLine_(""); \
+            satLogLine_.stream() << msg; \
+        } \
+    } while (0)
+
+#if SAT_LOG_LEVEL >= SAT_LOG_ERROR
+#define LOG_ERROR(msg) SAT_LOG_AT(SAT_LOG_ERROR, "[ERROR] ", msg)
+#else
+#define LOG_ERROR(msg) SAT_LOG_OFF(msg)
+#endif
+
+#if SAT_LOG_LEVEL >= SAT_LOG_INFO
+#define LOG_INFO(msg) SAT_LOG_AT(SAT_LOG_INFO, "[INFO] ", msg)
+#else
+#define LOG_INFO(msg) SAT_LOG_OFF(msg)
+#endif
+
+#if SAT_LOG_LEVEL >= SAT_LOG_DEBUG
+#define LOG_DEBUG(msg) SAT_LOG_AT(SAT_LOG_DEBUG, "[DEBUG] ", msg)
+#else
+#define LOG_DEBUG(msg) SAT_LOG_OFF(msg)
+#endif
+
+#if SAT_LOG_LEVEL >= SAT_LOG_TRACE
+#define LOG_TRACE(msg) SAT_LOG_AT(SAT_LOG_TRACE, "[TRACE] ", msg)
+#else
+#define LOG_TRACE(msg) SAT_LOG_OFF(msg)
+#endif
+
+// True when statements of the level are compiled in and enabled; guards
+// work that only feeds a log statement
+#define LOG_ENABLED(level) (SAT_LOG_##level <= SAT_LOG_LEVEL && satlog::enabled(SAT_LOG_##level))
+
+#endif // LOG_H
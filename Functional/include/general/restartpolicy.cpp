@@ -0,0 +1,60 @@
+#include "./restartpolicy.h"
+
+void RestartPolicy::reset() {
+    restarts = 0;
+    conflictsSinceRestart = 0;
+    fastLbd = slowLbd = 0.0;
+    fastBias = slowBias = 1.0;
+    limit = (strategy == RestartStrategy::Luby) ? static_cast<uint64_t>(luby(2, 0) * interval) : interval;
+}
+
+void RestartPolicy::onConflict(unsigned lbd) {
+    conflictsSinceRestart++;
+    if (strategy != RestartStrategy::Glucose) return;
+
+    fastLbd += FAST_ALPHA * (lbd - fastLbd);
+    slowLbd += SLOW_ALPHA * (lbd - slowLbd);
+    fastBias *= 1.0 - FAST_ALPHA;
+    slowBias *= 1.0 - SLOW_ALPHA;
+}
+
+bool RestartPolicy::shouldRestart() const {
+    switch (strategy) {
+    case RestartStrategy::Fixed:
+    case RestartStrategy::Luby:
+        return conflictsSinceRestart >= limit;
+    case RestartStrategy::Glucose: {
+        if (conflictsSinceRestart < MIN_CONFLICTS) return false;
+        double fast = fastLbd / (1.0 - fastBias);
+        double slow = slowLbd / (1.0 - slowBias);
+        return fast > MARGIN * slow;
+    }
+    default:
+        return false;
+    }
+}
+
+void RestartPolicy::onRestart() {
+    restarts++;
+    conflictsSinceRestart = 0;
+    if (strategy == RestartStrategy::Luby) {
+        limit = static_cast<uint64_t>(luby(2, static_cast<int>(restarts)) * interval);
+    }
+}
+
+// Finite subsequences of the Luby sequence with base y:
+// 0: 1, 1: 1 1 2, 2: 1 1 2 1 1 2 4, ...
+double RestartPolicy::luby(double y, int x) {
+    int size, seq;
+    for (size = 1, seq = 0; size < x + 1; seq++, size = 2 * size + 1);
+
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+
+    double result = 1.0;
+    for (int i = 0; i < seq; i++) result *= y;
+    return result;
+}
@@ -0,0 +1,57 @@
+#ifndef RESTARTPOLICY_H
+#define RESTARTPOLICY_H
+
+#include <cstdint>
+
+#pragma once
+
+using namespace std;
+
+enum class RestartStrategy {
+    None,     // never restart
+    Fixed,    // every interval conflicts
+    Luby,     // interval * luby(i): 1 1 2 1 1 2 4 1 1 2 ...
+    Glucose   // when the recent LBD average exceeds the long-term one
+};
+
+// Decides when a search engine should throw away its decisions and start
+// again from level 0. The engine reports every conflict (with the LBD of
+// the clause it learned, if any) and asks shouldRestart() afterwards.
+class RestartPolicy {
+public:
+    RestartPolicy(RestartStrategy strategy = RestartStrategy::None, uint64_t interval = 100)
+        : strategy(strategy), interval(interval) { reset(); }
+
+    void setStrategy(RestartStrategy s, uint64_t i) { strategy = s; interval = i; reset(); }
+    RestartStrategy getStrategy() const { return strategy; }
+
+    void reset();
+    void onConflict(unsigned lbd);
+    bool shouldRestart() const;
+    void onRestart();  // call after the engine went back to level 0
+
+    uint64_t getRestarts() const { return restarts; }
+
+    static double luby(double y, int x);
+
+    // Glucose-style exponential moving averages of the LBD
+    static constexpr double FAST_ALPHA = 1.0 / 32;
+    static constexpr double SLOW_ALPHA = 1.0 / 16384;
+    static constexpr double MARGIN = 1.25;          // restart when fast > MARGIN * slow
+    static constexpr uint64_t MIN_CONFLICTS = 50;   // between two EMA restarts
+
+private:
+    RestartStrategy strategy;
+    uint64_t interval;  // conflicts per restart (Fixed) or the Luby unit
+
+    uint64_t restarts = 0;
+    uint64_t conflictsSinceRestart = 0;
+    uint64_t limit = 0;  // conflicts allowed before the next Fixed/Luby restart
+
+    // The averages start at 0 and are divided by 1 - (1 - alpha)^n so
+    // early values are not biased towards 0
+    double fastLbd = 0.0, slowLbd = 0.0;
+    double fastBias = 1.0, slowBias = 1.0;
+};
+
+#endif // RESTARTPOLICY_H
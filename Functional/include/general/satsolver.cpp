@@ -1,161 +1,289 @@
 #include "./satsolver.h"
-#include "../parser/DIMACSParser.h"
+#include "./log.h"
 #include <algorithm> // For std::remove
 #include <map>
 
-// Constructor to initialize SATSolver with DIMACSParser
-SATSolver::SATSolver(const string& filename) {
-    cout << "[DEBUG] Initializing SATSolver with file: " << filename << endl;
-    DIMACSParser parser(filename);
-    numLiterals = parser.getNumLiterals();
-    numClauses = parser.getNumClauses();
-    clauses = parser.getClauses();
-    cout << "[DEBUG] Number of literals: " << numLiterals << ", Number of clauses: " << numClauses << endl;
-    printClauses();
-}
+SATSolver::SATSolver(const string& filename) : SATSolver(Formula::load(filename)) {}
 
-void SATSolver::initializeWatchedLiterals() {
-    watchedClauses.clear();
-    literalToClauses.clear();
-    
-    for (size_t i = 0; i < clauses.size(); i++) {
-        if (clauses[i].size() >= 2) {
-            WatchedClause wc;
-            wc.watch1 = clauses[i][0];
-            wc.watch2 = clauses[i][1];
-            wc.clause = clauses[i];
-            watchedClauses.push_back(wc);
-            
-            literalToClauses[wc.watch1].push_back(i);
-            literalToClauses[wc.watch2].push_back(i);
+SATSolver::SATSolver(shared_ptr<const Formula> formula) : formula(move(formula)) {
+    const Formula& input = *this->formula;
+    numLiterals = input.getNumLiterals();
+    numClauses = input.getNumClauses();
+    numVars = input.getNumVars();
+
+    // Copy the formula's flat buffer into the arena: one header word per
+    // clause in place of each 0 terminator, no per-clause allocation
+    span<const int> literals = input.getLiterals();
+    ca.reserve(literals.size() + input.getNumParsedClauses());
+    clauses.reserve(input.getNumParsedClauses());
+    size_t start = 0;
+    for (size_t i = 0; i < literals.size(); i++) {
+        if (literals[i] == 0) {
+            clauses.push_back(ca.alloc(&literals[start], i - start));
+            start = i + 1;
         }
     }
+    values.assign(numVars + 1, 0);
+    varData.assign(numVars + 1, {0, CREF_UNDEF});
+    savedPhase.assign(numVars + 1, 0);
+    targetPhase.assign(numVars + 1, 0);
+
+    LOG_DEBUG("Number of literals: " << numLiterals << ", Number of clauses: " << numClauses);
+    if (LOG_ENABLED(TRACE)) {
+        for (CRef cr : clauses) LOG_TRACE(satlog::join(ca[cr]) << "0");
+    }
 }
 
-bool SATSolver::updateWatchedLiterals(int literal, vector<int>& assignment) {
-    vector<size_t> clausesToUpdate = literalToClauses[-literal];
-    bool conflict = false;
-    
-    for (size_t clauseIdx : clausesToUpdate) {
-        WatchedClause& wc = watchedClauses[clauseIdx];
-        
-        // If the other watched literal is true, clause is satisfied
-        if (find(assignment.begin(), assignment.end(), wc.watch1) != assignment.end() ||
-            find(assignment.begin(), assignment.end(), wc.watch2) != assignment.end()) {
-            continue;
+// Record the value, level and reason of a literal; callers push it to the trail
+void SATSolver::assignValue(int literal, CRef reason) {
+    int var = abs(literal);
+    values[var] = (literal > 0) ? 1 : -1;
+    varData[var].level = decisionLevel();
+    varData[var].reason = reason;
+}
+
+void SATSolver::clearAssignment() {
+    fill(values.begin(), values.end(), 0);
+    assignment.clear();
+    trailLim.clear();
+    qhead = 0;
+}
+
+// Undo every literal assigned above the given decision level
+void SATSolver::backtrack(int level) {
+    if (decisionLevel() <= level) return;
+    // Everything below the top level was propagated without a conflict
+    if (phaseMode == PhaseMode::Target || phaseMode == PhaseMode::Best) {
+        updateTargetPhase(trailLim.back());
+    }
+
+    size_t target = trailLim[level];
+    while (assignment.size() > target) {
+        int var = abs(assignment.back());
+        savedPhase[var] = values[var];
+        values[var] = 0;
+        if (useActivityOrder) orderHeap.insert(var);
+        assignment.pop_back();
+    }
+    trailLim.resize(level);
+    qhead = min(qhead, assignment.size());
+}
+
+// Variables may appear after construction (incremental clauses); every
+// per-variable array is extended, and new variables join the order heap
+void SATSolver::growVars(int var) {
+    if (var <= numVars) return;
+    int first = numVars + 1;
+    numVars = var;
+    values.resize(numVars + 1, 0);
+    varData.resize(numVars + 1, {0, CREF_UNDEF});
+    savedPhase.resize(numVars + 1, 0);
+    targetPhase.resize(numVars + 1, 0);
+    if (!watches.empty()) watches.resize(2 * (numVars + 1));
+    if (useActivityOrder) {
+        activity.resize(numVars + 1, 0.0);
+        for (int v = first; v <= numVars; v++) orderHeap.insert(v);
+    }
+}
+
+int SATSolver::pickPhase(int var, int preferred) const {
+    int phase = 0;
+    if ((phaseMode == PhaseMode::Target || phaseMode == PhaseMode::Best) && targetSize > 0) {
+        phase = targetPhase[var];
+    }
+    if (phase == 0 && phaseMode != PhaseMode::Heuristic) {
+        phase = savedPhase[var];
+    }
+    if (phase == 0) return preferred;
+    return phase > 0 ? var : -var;
+}
+
+// Copy the first prefix trail literals if they form a longer conflict-free
+// assignment than the current target; this only costs anything when the
+// search gets further than before
+void SATSolver::updateTargetPhase(size_t prefix) {
+    if (prefix <= targetSize) return;
+    fill(targetPhase.begin(), targetPhase.end(), 0);
+    for (size_t i = 0; i < prefix; i++) {
+        int lit = assignment[i];
+        targetPhase[abs(lit)] = lit > 0 ? 1 : -1;
+    }
+    targetSize = prefix;
+}
+
+void SATSolver::setSeed(uint64_t value) {
+    seed = value;
+    rng.seed(seed);
+    if (seed == 0) return;
+    for (int var = 1; var <= numVars; var++) savedPhase[var] = (rng() & 1) ? 1 : -1;
+}
+
+void SATSolver::initActivityOrder() {
+    activity.assign(numVars + 1, 0.0);
+    varInc = 1.0;
+    if (seed != 0) {
+        // Far below one bump, so only ties between untouched variables change
+        uniform_real_distribution<double> jitter(0.0, 1e-5);
+        for (int var = 1; var <= numVars; var++) activity[var] = jitter(rng);
+    }
+    orderHeap.reset(numVars);
+    for (int var = 1; var <= numVars; var++) {
+        if (values[var] == 0) orderHeap.insert(var);
+    }
+    useActivityOrder = true;
+}
+
+void SATSolver::bumpActivity(int var) {
+    activity[var] += varInc;
+    if (activity[var] > 1e100) {
+        // Rescale everything to keep the doubles in range; order is unchanged
+        for (double& a : activity) a *= 1e-100;
+        varInc *= 1e-100;
+    }
+    orderHeap.increase(var);
+}
+
+int SATSolver::pickActivityVariable() {
+    while (!orderHeap.empty()) {
+        int var = orderHeap.removeMax();
+        if (values[var] == 0) return var;
+    }
+    return 0;
+}
+
+unsigned SATSolver::computeLbd(const int* lits, size_t size) {
+    // Assumptions that already hold add empty levels, so there can be
+    // more levels than variables
+    size_t levels = max(values.size(), static_cast<size_t>(decisionLevel()) + 1);
+    if (levelStamp.size() < levels) levelStamp.resize(levels, 0);
+    stampCounter++;
+    unsigned lbd = 0;
+    for (size_t i = 0; i < size; i++) {
+        int level = varData[abs(lits[i])].level;
+        if (levelStamp[level] != stampCounter) {
+            levelStamp[level] = stampCounter;
+            lbd++;
         }
-        
-        // Try to find a new literal to watch
-        bool foundNewWatch = false;
-        for (int lit : wc.clause) {
-            if (lit != wc.watch1 && lit != wc.watch2 &&
-                find(assignment.begin(), assignment.end(), -lit) == assignment.end()) {
-                // Update watched literals
-                if (wc.watch1 == -literal) {
-                    wc.watch1 = lit;
-                } else {
-                    wc.watch2 = lit;
-                }
-                literalToClauses[lit].push_back(clauseIdx);
-                foundNewWatch = true;
-                break;
-            }
+    }
+    return lbd;
+}
+
+bool SATSolver::initializeWatchedLiterals() {
+    watches.assign(2 * (numVars + 1), {});
+    qhead = assignment.size();
+
+    for (CRef cr : clauses) {
+        Clause clause = ca[cr];
+        if (clause.size() == 0) {
+            return false;
         }
-        
-        if (!foundNewWatch) {
-            // No new watch found, check if clause is unit
-            int unassignedLit = (wc.watch1 == -literal) ? wc.watch2 : wc.watch1;
-            if (find(assignment.begin(), assignment.end(), -unassignedLit) == assignment.end()) {
-                // Unit clause found
-                assignment.push_back(unassignedLit);
-                propagateWatchedLiterals(unassignedLit, assignment);
-            } else {
-                // Conflict found
-                conflict = true;
-                break;
+        if (clause.size() == 1) {
+            // Unit clauses are assigned at level 0 instead of being watched
+            int value = literalValue(clause[0]);
+            if (value < 0) return false;
+            if (value == 0) {
+                assignValue(clause[0], cr);
+                assignment.push_back(clause[0]);
             }
+            continue;
         }
+        attachClause(cr);
     }
-    
-    return conflict;
+    return true;
 }
 
-void SATSolver::propagateWatchedLiterals(int literal, vector<int>& assignment) {
-    vector<size_t> clausesToUpdate = literalToClauses[-literal];
-    
-    for (size_t clauseIdx : clausesToUpdate) {
-        WatchedClause& wc = watchedClauses[clauseIdx];
-        
-        // If the other watched literal is true, clause is satisfied
-        if (find(assignment.begin(), assignment.end(), wc.watch1) != assignment.end() ||
-            find(assignment.begin(), assignment.end(), wc.watch2) != assignment.end()) {
-            continue;
-        }
-        
-        // Try to find a new literal to watch
-        bool foundNewWatch = false;
-        for (int lit : wc.clause) {
-            if (lit != wc.watch1 && lit != wc.watch2 &&
-                find(assignment.begin(), assignment.end(), -lit) == assignment.end()) {
-                // Update watched literals
-                if (wc.watch1 == -literal) {
-                    wc.watch1 = lit;
-                } else {
-                    wc.watch2 = lit;
+// Watch the first two literals of a clause with at least two literals
+void SATSolver::attachClause(CRef cr) {
+    const Clause clause = ca[cr];
+    watches[litIndex(clause[0])].push_back({cr, clause[1]});
+    watches[litIndex(clause[1])].push_back({cr, clause[0]});
+}
+
+CRef SATSolver::propagate() {
+    CRef conflict = CREF_UNDEF;
+
+    while (qhead < assignment.size() && conflict == CREF_UNDEF) {
+        int falseLit = -assignment[qhead++];
+        vector<Watcher>& ws = watches[litIndex(falseLit)];
+
+        // Compact the watch list in place while visiting it
+        size_t i = 0, j = 0;
+        while (i < ws.size()) {
+            Watcher w = ws[i++];
+            if (literalValue(w.blocker) > 0) {
+                ws[j++] = w;
+                continue;
+            }
+
+            // Make sure the false literal is at position 1
+            Clause clause = ca[w.cref];
+            if (clause[0] == falseLit) {
+                swap(clause[0], clause[1]);
+            }
+            int first = clause[0];
+            Watcher updated = {w.cref, first};
+            if (first != w.blocker && literalValue(first) > 0) {
+                ws[j++] = updated;
+                continue;
+            }
+
+            // Look for a new literal to watch; the watch moves to its list
+            bool foundNewWatch = false;
+            for (uint32_t k = 2; k < clause.size(); k++) {
+                if (literalValue(clause[k]) >= 0) {
+                    clause[1] = clause[k];
+                    clause[k] = falseLit;
+                    watches[litIndex(clause[1])].push_back(updated);
+                    foundNewWatch = true;
+                    break;
                 }
-                literalToClauses[lit].push_back(clauseIdx);
-                foundNewWatch = true;
-                break;
             }
-        }
-        
-        if (!foundNewWatch) {
-            // No new watch found, check if clause is unit
-            int unassignedLit = (wc.watch1 == -literal) ? wc.watch2 : wc.watch1;
-            if (find(assignment.begin(), assignment.end(), -unassignedLit) == assignment.end()) {
-                // Unit clause found
-                assignment.push_back(unassignedLit);
-                propagateWatchedLiterals(unassignedLit, assignment);
+            if (foundNewWatch) continue;
+
+            // Clause is unit or conflicting under the current assignment
+            ws[j++] = updated;
+            if (literalValue(first) < 0) {
+                conflict = w.cref;
+                qhead = assignment.size();
+                while (i < ws.size()) ws[j++] = ws[i++];
+            } else {
+                assignValue(first, w.cref);
+                assignment.push_back(first);
             }
         }
+        ws.resize(j);
     }
+
+    return conflict;
 }
 
 void SATSolver::unitPropagation(vector<int>& assignment) {
-    cout << "[DEBUG] Starting unit propagation..." << endl;
-    
-    // Initialize watched literals if not already done
-    if (watchedClauses.empty()) {
-        initializeWatchedLiterals();
-    }
-    
+    LOG_DEBUG("Starting unit propagation...");
+
+    // The clause list is rewritten here, so units are applied directly
+    // instead of going through the watch lists used by the search solvers
     bool changed;
     do {
         changed = false;
         
         // Process unit clauses
-        for (auto it = clauses.begin(); it != clauses.end();) {
-            if (it->size() == 1) {
-                int unit = (*it)[0];
-                cout << "[DEBUG] Propagating unit: " << unit << endl;
+        for (CRef cr : clauses) {
+            if (ca[cr].size() == 1) {
+                int unit = ca[cr][0];
+                LOG_TRACE("Propagating unit: " << unit);
                 assignment.push_back(unit);
-                
-                // Update watched literals
-                if (updateWatchedLiterals(unit, assignment)) {
-                    clauses = {vector<int>()}; // Empty clause indicates UNSAT
-                    return;
-                }
-                
-                // Remove unit clause
-                it = clauses.erase(it);
+                assignValue(unit);
+
+                // Drops the satisfied clauses (including this one) and the
+                // negated occurrences; a unit {-unit} becomes the empty clause
+                simplifyClauses(unit);
                 changed = true;
-            } else {
-                ++it;
+                break;
             }
         }
-    } while (changed);
+    } while (changed && !checkEmptyClause());
     
-    cout << "[DEBUG] Unit propagation completed." << endl;
+    LOG_DEBUG("Unit propagation completed.");
 }
 
 void SATSolver::eliminatePureLiterals(vector<int>& assignment) {
@@ -165,15 +293,15 @@ void SATSolver::eliminatePureLiterals(vector<int>& assignment) {
         map<int, int> literalCount;  // tracks positive and negative occurrences
         
         // Count occurrences
-        for (const auto& clause : clauses) {
-            for (int lit : clause) {
+        for (CRef cr : clauses) {
+            for (int lit : ca[cr]) {
                 int var = abs(lit);
                 if (lit > 0) literalCount[var]++;
                 else literalCount[-var]--;
             }
         }
         
-        vector<vector<int>> newClauses;
+        vector<CRef> newClauses;
         bool clauseRemoved = false;
         
         // Find and process pure literals
@@ -183,15 +311,17 @@ void SATSolver::eliminatePureLiterals(vector<int>& assignment) {
             if (var > 0) { // Only process positive variables
                 // Check if literal appears pure positive
                 if (literalCount.find(-var) == literalCount.end()) {
-                    cout << "[DEBUG] Pure positive literal found: " << var << endl;
+                    LOG_TRACE("Pure positive literal found: " << var);
                     assignment.push_back(var);
+                    assignValue(var);
                     changed = true;
                     clauseRemoved = true;
                 }
                 // Check if literal appears pure negative
                 else if (literalCount.find(var) == literalCount.end()) {
-                    cout << "[DEBUG] Pure negative literal found: " << -var << endl;
+                    LOG_TRACE("Pure negative literal found: " << -var);
                     assignment.push_back(-var);
+                    assignValue(-var);
                     changed = true;
                     clauseRemoved = true;
                 }
@@ -201,9 +331,9 @@ void SATSolver::eliminatePureLiterals(vector<int>& assignment) {
         // Update clauses if we found pure literals
         if (clauseRemoved) {
             // Keep only clauses that don't contain any pure literals
-            for (const auto& clause : clauses) {
+            for (CRef cr : clauses) {
                 bool keepClause = true;
-                for (int lit : clause) {
+                for (int lit : ca[cr]) {
                     int var = abs(lit);
                     if ((lit > 0 && literalCount.find(-var) == literalCount.end()) ||
                         (lit < 0 && literalCount.find(var) == literalCount.end())) {
@@ -212,18 +342,18 @@ void SATSolver::eliminatePureLiterals(vector<int>& assignment) {
                     }
                 }
                 if (keepClause) {
-                    newClauses.push_back(clause);
+                    newClauses.push_back(cr);
+                } else {
+                    ca.free(cr);
                 }
             }
             clauses = newClauses;
+            checkGarbage();
         }
         
-        cout << "[DEBUG] Current clauses:" << endl;
-        for (const auto& clause : clauses) {
-            for (int lit : clause) {
-                cout << lit << " ";
-            }
-            cout << "0" << endl;
+        if (LOG_ENABLED(TRACE)) {
+            LOG_TRACE("Current clauses:");
+            for (CRef cr : clauses) LOG_TRACE(satlog::join(ca[cr]) << "0");
         }
         
     } while (changed && !clauses.empty());
@@ -231,84 +361,135 @@ void SATSolver::eliminatePureLiterals(vector<int>& assignment) {
 
 // Utility: Check if there is an empty clause
 bool SATSolver::checkEmptyClause() const {
-    cout << "[DEBUG] Checking for empty clauses..." << endl;
+    LOG_TRACE("Checking for empty clauses...");
     if (clauses.empty()) {
-        cout << "[DEBUG] All clauses are satisfied." << endl;
+        LOG_DEBUG("All clauses are satisfied.");
         return false;
     }
-    for (const auto& clause : clauses) {
-        if (clause.empty()) {
-            cout << "[DEBUG] Empty clause found!" << endl;
+    for (CRef cr : clauses) {
+        if (ca[cr].size() == 0) {
+            LOG_DEBUG("Empty clause found!");
             return true;
         }
     }
-    cout << "[DEBUG] No empty clauses found." << endl;
+    LOG_TRACE("No empty clauses found.");
     return false;
 }
 
 bool SATSolver::checkContradictions() {
-    cout << "[DEBUG] Checking for contradictions in binary clauses..." << endl;
+    LOG_DEBUG("Checking for contradictions in binary clauses...");
     for (size_t i = 0; i < clauses.size(); i++) {
-        if (clauses[i].size() == 2) {
-            int lit1 = clauses[i][0];
-            int lit2 = clauses[i][1];
+        const Clause first = ca[clauses[i]];
+        if (first.size() == 2) {
+            int lit1 = first[0];
+            int lit2 = first[1];
 
             // Look for complementary pair
             for (size_t j = i + 1; j < clauses.size(); j++) {
-                if (clauses[j].size() == 2) {
-                    if ((clauses[j][0] == -lit1 && clauses[j][1] == -lit2) ||
-                        (clauses[j][0] == -lit2 && clauses[j][1] == -lit1)) {
-                        cout << "[DEBUG] Contradiction found in binary clauses: (" << lit1 << ", " << lit2
-                             << ") and (" << -lit1 << ", " << -lit2 << ")" << endl;
+                const Clause second = ca[clauses[j]];
+                if (second.size() == 2) {
+                    if ((second[0] == -lit1 && second[1] == -lit2) ||
+                        (second[0] == -lit2 && second[1] == -lit1)) {
+                        LOG_DEBUG("Contradiction found in binary clauses: (" << lit1 << ", " << lit2
+                                  << ") and (" << -lit1 << ", " << -lit2 << ")");
                         return true;
                     }
                 }
             }
         }
     }
-    cout << "[DEBUG] No contradictions found in binary clauses." << endl;
+    LOG_DEBUG("No contradictions found in binary clauses.");
     return false;
 }
 
 void SATSolver::printClauses() const {
-    cout << "[DEBUG] Current clauses:" << endl;
-    for (const auto& clause : clauses) {
-        for (int literal : clause) {
+    cout << "Current clauses:\n";
+    for (CRef cr : clauses) {
+        for (int literal : ca[cr]) {
             cout << literal << " ";
         }
-        cout << "0" << endl;
+        cout << "0\n";
     }
 }
 
 vector<vector<int>> SATSolver::getClauses() const {
-    return clauses;
+    vector<vector<int>> result;
+    result.reserve(clauses.size());
+    for (CRef cr : clauses) {
+        const Clause clause = ca[cr];
+        result.emplace_back(clause.begin(), clause.end());
+    }
+    return result;
 }
 
 void SATSolver::addToAssignment(int var) {
     assignment.push_back(var);
+    assignValue(var);
+    simplifyClauses(var);
+}
 
-    // Create a new vector for updated clauses
-    vector<vector<int>> newClauses;
+// Remove clauses satisfied by the literal and strip its negation elsewhere
+void SATSolver::simplifyClauses(int var) {
+    // Satisfied clauses leave the active list; the others shrink in place
+    size_t j = 0;
+    for (size_t i = 0; i < clauses.size(); i++) {
+        Clause clause = ca[clauses[i]];
 
-    for (const auto& clause : clauses) {
         // If clause contains the literal, it's satisfied
-        if (find(clause.begin(), clause.end(), var) != clause.end()) {
+        if (clause.contains(var)) {
+            ca.free(clauses[i]);
             continue;
         }
 
-        // If clause contains the negation, remove just that literal
-        vector<int> newClause;
-        for (int lit : clause) {
-            if (lit != -var) {
-                newClause.push_back(lit);
-            }
+        // If clause contains the negation, remove just that literal. The
+        // empty clause is kept so the conflict is visible to checkEmptyClause
+        ca.removeLiteral(clauses[i], -var);
+        clauses[j++] = clauses[i];
+    }
+    clauses.resize(j);
+    checkGarbage();
+}
+
+void SATSolver::checkGarbage(double fraction) {
+    if (ca.wasted() > ca.size() * fraction) garbageCollect();
+}
+
+void SATSolver::garbageCollect() {
+    ClauseArena to;
+    to.reserve(ca.size() - ca.wasted());
+    relocateClauses(to);
+    LOG_DEBUG("Arena compacted: " << ca.size() << " -> " << to.size() << " words");
+    to.moveTo(ca);
+}
+
+void SATSolver::relocateClauses(ClauseArena& to) {
+    // Watch lists first, so clauses watched together end up close together
+    for (auto& list : watches) {
+        size_t j = 0;
+        for (size_t i = 0; i < list.size(); i++) {
+            if (ca[list[i].cref].deleted()) continue;
+            ca.relocate(list[i].cref, to);
+            list[j++] = list[i];
         }
+        list.resize(j);
+    }
 
-        // Only add non-empty clauses
-        if (!newClause.empty()) {
-            newClauses.push_back(newClause);
+    // Reasons of the assigned literals
+    for (int lit : assignment) {
+        CRef& reason = varData[abs(lit)].reason;
+        if (reason == CREF_UNDEF) continue;
+        if (ca[reason].deleted()) {
+            reason = CREF_UNDEF;
+        } else {
+            ca.relocate(reason, to);
         }
     }
 
-    clauses = newClauses;
-}
\ No newline at end of file
+    size_t j = 0;
+    for (size_t i = 0; i < clauses.size(); i++) {
+        if (ca[clauses[i]].deleted()) continue;
+        ca.relocate(clauses[i], to);
+        clauses[j++] = clauses[i];
+    }
+    clauses.resize(j);
+}
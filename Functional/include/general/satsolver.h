@@ -4,15 +4,43 @@
 #include <vector>
 #include <string>
 #include <iostream>
-#include <unordered_map>
+#include <cstdlib>
+#include <memory>
+#include <functional>
+#include <random>
+#include "./clausearena.h"
+#include "./formula.h"
+#include "./varheap.h"
+#include "./restartpolicy.h"
 
 #pragma once
 
 using namespace std;
 
+// Polarity given to a decision variable
+enum class PhaseMode {
+    Heuristic,  // whatever the branching heuristic proposes
+    Saved,      // the value the variable had when it was last unassigned
+    Target,     // the value on the longest conflict-free trail since the last restart
+    Best        // the value on the longest conflict-free trail of the whole run
+};
+
+// Outcome of a search; the values are the SAT competition exit codes
+enum class SolveResult {
+    Unknown = 0,  // interrupted before an answer was found
+    Sat = 10,
+    Unsat = 20
+};
+
 class SATSolver {
 public:
     SATSolver(const string& filename);
+    // The formula is shared, not copied: solvers built from the same
+    // Formula parse the file only once
+    explicit SATSolver(shared_ptr<const Formula> formula);
+    // Neither copied nor moved: orderHeap refers to this solver's activity
+    SATSolver(const SATSolver&) = delete;
+    SATSolver& operator=(const SATSolver&) = delete;
     void unitPropagation(vector<int>& assignment);
     void eliminatePureLiterals(vector<int>& assignment);
     bool checkEmptyClause() const;
@@ -29,29 +57,136 @@ public:
     // Fix the getter functions
     int getNumLiterals() const { return numLiterals; }
     int getNumClauses() const { return numClauses; }
+    int getNumVars() const { return numVars; }
+    const shared_ptr<const Formula>& getFormula() const { return formula; }
+
+    // Value of a literal under the current assignment: 1 true, -1 false, 0 unassigned
+    int literalValue(int literal) const {
+        int v = values[abs(literal)];
+        return literal > 0 ? v : -v;
+    }
 
     virtual void addToAssignment(int literal);
 
-    vector<vector<int>> clauses;
+    // Restart strategy of the search engines; interval is the number of
+    // conflicts between restarts (Fixed) or the Luby unit
+    void setRestartStrategy(RestartStrategy strategy, uint64_t interval = 100) {
+        restartPolicy.setStrategy(strategy, interval);
+    }
+    uint64_t getRestarts() const { return restartPolicy.getRestarts(); }
+
+    void setPhaseMode(PhaseMode mode) { phaseMode = mode; }
+
+    // Diversification for parallel runs. A non-zero seed gives every
+    // variable a random saved phase now and a small random activity
+    // whenever the activity order is built, so equally configured solvers
+    // with different seeds search in different directions. 0 (the
+    // default) keeps the deterministic behaviour.
+    void setSeed(uint64_t value);
+
+    // Polled by the search loops (after conflicts or steps); once it
+    // returns true the search stops and wasInterrupted() is set. The answer
+    // of an interrupted solve() means nothing.
+    void setTerminate(function<bool()> callback) { terminate = move(callback); }
+    bool wasInterrupted() const { return interrupted; }
+
+    // All clauses are stored in the arena; clauses lists the active ones
+    ClauseArena ca;
+    vector<CRef> clauses;
     vector<int> assignment;
 
 protected:
+    shared_ptr<const Formula> formula;  // the input, unchanged by solving
     int numLiterals;
     int numClauses;
-    
-    // Watched literals data structures
-    struct WatchedClause {
-        int watch1;
-        int watch2;
-        vector<int> clause;
+    int numVars;  // highest variable index seen (header count or larger)
+
+    // Dense per-variable assignment state, indexed by variable. The
+    // assignment vector holds the assigned literals in order (the trail)
+    // and trailLim marks where each decision level starts.
+    struct VarData {
+        int level;   // decision level the variable was assigned at
+        CRef reason;  // implying clause, CREF_UNDEF for decisions
     };
+    vector<signed char> values;  // 1 true, -1 false, 0 unassigned
+    vector<VarData> varData;
+    vector<size_t> trailLim;
+
+    int decisionLevel() const { return static_cast<int>(trailLim.size()); }
+    void newDecisionLevel() { trailLim.push_back(assignment.size()); }
+    void assignValue(int literal, CRef reason = CREF_UNDEF);
+    void clearAssignment();
+    void backtrack(int level);
+    void growVars(int var);  // makes room for variables up to var
     
-    vector<WatchedClause> watchedClauses;
-    unordered_map<int, vector<size_t>> literalToClauses; // Maps literals to clause indices
-    
-    void initializeWatchedLiterals();
-    bool updateWatchedLiterals(int literal, vector<int>& assignment);
-    void propagateWatchedLiterals(int literal, vector<int>& assignment);
+    // Watched literals data structures. Watch lists are indexed by the
+    // encoded literal (2*var + sign); a clause is watched by its first two
+    // literals, which propagate() keeps at positions 0 and 1.
+    struct Watcher {
+        CRef cref;
+        int blocker;  // another literal of the clause; if true, the clause is skipped
+    };
+
+    vector<vector<Watcher>> watches;
+    size_t qhead = 0;  // next trail position to propagate
+
+    // Activity-based variable order (EVSIDS): variables in recent conflicts
+    // get bumped by varInc, which grows after each conflict so older bumps
+    // decay geometrically. Unassigned variables wait in orderHeap.
+    vector<double> activity;
+    double varInc = 1.0;
+    double varDecay = 0.95;
+    VarHeap orderHeap{activity};
+    bool useActivityOrder = false;
+
+    void initActivityOrder();
+    void bumpActivity(int var);
+    void decayActivity() { varInc /= varDecay; }
+    int pickActivityVariable();  // most active unassigned variable, 0 if none
+
+    uint64_t seed = 0;
+    mt19937_64 rng;
+
+    RestartPolicy restartPolicy;
+
+    function<bool()> terminate;
+    bool interrupted = false;
+    bool stopRequested() {
+        if (!interrupted && terminate && terminate()) interrupted = true;
+        return interrupted;
+    }
+
+    // Phases. savedPhase is written by backtrack() for every variable it
+    // unassigns; targetPhase is a copy of the longest conflict-free trail
+    // prefix seen so far (targetSize literals), forgotten on restart in
+    // Target mode. Both hold 1, -1 or 0 for "no value yet".
+    PhaseMode phaseMode = PhaseMode::Saved;
+    vector<signed char> savedPhase;
+    vector<signed char> targetPhase;
+    size_t targetSize = 0;
+
+    int pickPhase(int var, int preferred) const;  // literal of var to branch on
+    void updateTargetPhase(size_t prefix);
+    void resetTargetPhase() { if (phaseMode == PhaseMode::Target) targetSize = 0; }
+
+    // Literal block distance: number of distinct decision levels among lits
+    unsigned computeLbd(const int* lits, size_t size);
+    vector<int> levelStamp;
+    int stampCounter = 0;
+
+    static size_t litIndex(int literal) { return 2 * static_cast<size_t>(abs(literal)) + (literal < 0); }
+    bool initializeWatchedLiterals();  // false if the formula is conflicting at level 0
+    void attachClause(CRef cr);
+    CRef propagate();                  // conflicting clause, or CREF_UNDEF
+    void simplifyClauses(int literal);
+
+    // Arena compaction. Freed clauses stay in the arena until their share
+    // of it passes the given fraction; then every live clause is copied to
+    // a fresh arena and all references are redirected. Solvers keeping
+    // references of their own extend relocateClauses().
+    void checkGarbage(double fraction = 0.2);
+    void garbageCollect();
+    virtual void relocateClauses(ClauseArena& to);
 };
 
 #endif // SATSOLVER_H
@@ -0,0 +1,74 @@
+#include "./threadpool.h"
+
+namespace {
+
+void* (*captureContext)() = nullptr;
+void (*adoptContext)(void*) = nullptr;
+
+} // namespace
+
+void ThreadPool::setThreadContext(void* (*capture)(), void (*adopt)(void*)) {
+    captureContext = capture;
+    adoptContext = adopt;
+}
+
+ThreadPool::ThreadPool(unsigned count) {
+    if (captureContext) context = captureContext();
+    if (count == 0) count = thread::hardware_concurrency();
+    if (count == 0) count = 1;
+    threads.reserve(count);
+    for (unsigned i = 0; i < count; i++) threads.emplace_back(&ThreadPool::run, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& t : threads) t.join();
+}
+
+void ThreadPool::submit(function<void()> task) {
+    {
+        lock_guard<mutex> guard(lock);
+        unfinished++;
+        tasks.push_back(move(task));
+    }
+    wake.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> guard(lock);
+    idle.wait(guard, [this] { return unfinished == 0; });
+    if (failure) {
+        exception_ptr error = failure;
+        failure = nullptr;
+        rethrow_exception(error);
+    }
+}
+
+// Workers leave once stopping is set and the queue is empty, so the
+// destructor still runs every task submitted before it
+void ThreadPool::run() {
+    if (adoptContext) adoptContext(context);
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [this] { return !tasks.empty() || stopping; });
+            if (tasks.empty()) return;
+            task = move(tasks.front());
+            tasks.pop_front();
+        }
+
+        try {
+            task();
+        } catch (...) {
+            lock_guard<mutex> guard(lock);
+            if (!failure) failure = current_exception();
+        }
+        lock_guard<mutex> guard(lock);
+        if (--unfinished == 0) idle.notify_all();
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#pragma once
+
+using namespace std;
+
+// Fixed-size thread pool with one shared queue: tasks are started in
+// submission order, by whichever worker is free first. Every user of the
+// pool submits its tasks up front (instances of a batch, solvers of a
+// portfolio), so there is no local work for per-worker queues to keep.
+// A task may still submit more tasks; they join the same queue.
+//
+// The first exception thrown by a task is kept and rethrown by wait().
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0);  // 0 for all cores
+    ~ThreadPool();  // runs the remaining tasks, then joins the workers
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(function<void()> task);
+
+    // Blocks until every submitted task has finished. Not to be called
+    // from a task of the same pool.
+    void wait();
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+
+    // Per-thread state a pool hands from the thread that builds it to its
+    // workers: capture() runs in the constructor, adopt() on every worker
+    // before its first task. Unset unless the program installs them; the
+    // command line charges the workers' heap use to the instance that
+    // built the pool (see cli/heapusage.h). To be set before any pool is
+    // built.
+    static void setThreadContext(void* (*capture)(), void (*adopt)(void*));
+
+private:
+    void run();
+
+    vector<thread> threads;
+    void* context = nullptr;          // captured for the workers
+
+    mutex lock;                       // guards everything below
+    condition_variable wake;          // tasks queued or stopping
+    condition_variable idle;          // unfinished dropped to 0
+    deque<function<void()>> tasks;    // submitted, not yet taken
+    size_t unfinished = 0;            // submitted, not yet finished
+    bool stopping = false;
+    exception_ptr failure;
+};
+
+#endif // THREADPOOL_H
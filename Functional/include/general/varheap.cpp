@@ -0,0 +1,65 @@
+#include "./varheap.h"
+
+void VarHeap::reset(int numVars) {
+    heap.clear();
+    indices.assign(numVars + 1, -1);
+}
+
+void VarHeap::insert(int var) {
+    if (contains(var)) return;
+    if (var >= static_cast<int>(indices.size())) indices.resize(var + 1, -1);
+    indices[var] = static_cast<int>(heap.size());
+    heap.push_back(var);
+    percolateUp(indices[var]);
+}
+
+int VarHeap::removeMax() {
+    int top = heap[0];
+    int last = heap.back();
+    heap.pop_back();
+    indices[top] = -1;
+    if (!heap.empty()) {
+        heap[0] = last;
+        indices[last] = 0;
+        percolateDown(0);
+    }
+    return top;
+}
+
+void VarHeap::increase(int var) {
+    if (contains(var)) percolateUp(indices[var]);
+}
+
+void VarHeap::rebuild() {
+    for (int i = static_cast<int>(heap.size()) / 2 - 1; i >= 0; i--) {
+        percolateDown(i);
+    }
+}
+
+void VarHeap::percolateUp(int pos) {
+    int var = heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!higher(var, heap[parent])) break;
+        heap[pos] = heap[parent];
+        indices[heap[pos]] = pos;
+        pos = parent;
+    }
+    heap[pos] = var;
+    indices[var] = pos;
+}
+
+void VarHeap::percolateDown(int pos) {
+    int var = heap[pos];
+    int n = static_cast<int>(heap.size());
+    while (2 * pos + 1 < n) {
+        int child = 2 * pos + 1;
+        if (child + 1 < n && higher(heap[child + 1], heap[child])) child++;
+        if (!higher(heap[child], var)) break;
+        heap[pos] = heap[child];
+        indices[heap[pos]] = pos;
+        pos = child;
+    }
+    heap[pos] = var;
+    indices[var] = pos;
+}
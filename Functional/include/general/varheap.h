@@ -0,0 +1,37 @@
+#ifndef VARHEAP_H
+#define VARHEAP_H
+
+#include <vector>
+
+#pragma once
+
+using namespace std;
+
+// Indexed binary max-heap of variables ordered by activity. Each variable
+// knows its position in the heap, so membership tests are O(1) and
+// insert/removeMax/increase are O(log n).
+class VarHeap {
+public:
+    explicit VarHeap(const vector<double>& activity) : activity(activity) {}
+
+    void reset(int numVars);  // empties the heap and sizes the index for numVars
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(int var) const { return var < static_cast<int>(indices.size()) && indices[var] >= 0; }
+
+    void insert(int var);
+    int removeMax();
+    void increase(int var);  // restore the heap after var's activity grew
+    void rebuild();          // restore the heap after every activity changed
+
+private:
+    bool higher(int a, int b) const { return activity[a] > activity[b]; }
+    void percolateUp(int pos);
+    void percolateDown(int pos);
+
+    const vector<double>& activity;
+    vector<int> heap;     // variables
+    vector<int> indices;  // position of each variable in heap, -1 if absent
+};
+
+#endif // VARHEAP_H
@@ -0,0 +1,88 @@
+#include "./ipasir.h"
+#include "../cdcl/cdclsolver.h"
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct IpasirSolver {
+    CDCLSolver solver;
+    vector<int> clause;       // literals added since the last 0
+    vector<int> assumptions;  // for the next solve call
+    vector<int32_t> learnBuffer;
+};
+
+IpasirSolver& state(void* solver) {
+    return *static_cast<IpasirSolver*>(solver);
+}
+
+} // namespace
+
+extern "C" {
+
+const char* ipasir_signature(void) {
+    return "MPI_SAT_Unified CDCL";
+}
+
+void* ipasir_init(void) {
+    return new IpasirSolver();
+}
+
+void ipasir_release(void* solver) {
+    delete static_cast<IpasirSolver*>(solver);
+}
+
+void ipasir_add(void* solver, int32_t lit_or_zero) {
+    IpasirSolver& s = state(solver);
+    if (lit_or_zero != 0) {
+        s.clause.push_back(lit_or_zero);
+        return;
+    }
+    s.solver.addClause(s.clause);
+    s.clause.clear();
+}
+
+void ipasir_assume(void* solver, int32_t lit) {
+    state(solver).assumptions.push_back(lit);
+}
+
+int ipasir_solve(void* solver) {
+    IpasirSolver& s = state(solver);
+    SolveResult result = s.solver.solve(s.assumptions);
+    s.assumptions.clear();
+    return static_cast<int>(result);
+}
+
+int32_t ipasir_val(void* solver, int32_t lit) {
+    int value = state(solver).solver.modelValue(lit);
+    if (value == 0) return 0;
+    return value > 0 ? lit : -lit;
+}
+
+int ipasir_failed(void* solver, int32_t lit) {
+    return state(solver).solver.failed(lit) ? 1 : 0;
+}
+
+void ipasir_set_terminate(void* solver, void* data, int (*terminate)(void* data)) {
+    if (terminate == nullptr) {
+        state(solver).solver.setTerminate(nullptr);
+        return;
+    }
+    state(solver).solver.setTerminate([data, terminate]() { return terminate(data) != 0; });
+}
+
+void ipasir_set_learn(void* solver, void* data, int max_length, void (*learn)(void* data, int32_t* clause)) {
+    IpasirSolver& s = state(solver);
+    if (learn == nullptr) {
+        s.solver.setLearnCallback(0, nullptr);
+        return;
+    }
+    s.solver.setLearnCallback(max_length, [&s, data, learn](const vector<int>& clause) {
+        s.learnBuffer.assign(clause.begin(), clause.end());
+        s.learnBuffer.push_back(0);
+        learn(data, s.learnBuffer.data());
+    });
+}
+
+} // extern "C"
@@ -0,0 +1,50 @@
+#ifndef IPASIR_H
+#define IPASIR_H
+
+#include <stdint.h>
+
+// IPASIR, the incremental SAT solver interface of the SAT Race 2015, backed
+// by CDCLSolver. Harnesses written against this header link the
+// ipasircdcl library. States: INPUT after init and after any add or
+// assume, SAT or UNSAT after the corresponding solve result.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Name and version of the solver
+const char* ipasir_signature(void);
+
+// New solver in state INPUT; release it with ipasir_release
+void* ipasir_init(void);
+void ipasir_release(void* solver);
+
+// Adds a literal to the clause being built, or finishes it with 0
+void ipasir_add(void* solver, int32_t lit_or_zero);
+
+// Assumes a literal for the next ipasir_solve call only
+void ipasir_assume(void* solver, int32_t lit);
+
+// 10 for SAT, 20 for UNSAT, 0 if interrupted by the terminate callback
+int ipasir_solve(void* solver);
+
+// In state SAT: lit if it is true in the model, -lit if false, 0 if the
+// variable never occurred
+int32_t ipasir_val(void* solver, int32_t lit);
+
+// In state UNSAT: 1 if the assumption lit was used to prove UNSAT
+int ipasir_failed(void* solver, int32_t lit);
+
+// terminate(data) is polled during the search; a nonzero result stops it.
+// A null callback removes it.
+void ipasir_set_terminate(void* solver, void* data, int (*terminate)(void* data));
+
+// learn(data, clause) receives every learnt clause of at most max_length
+// literals, as a 0-terminated array valid during the call only
+void ipasir_set_learn(void* solver, void* data, int max_length, void (*learn)(void* data, int32_t* clause));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IPASIR_H
@@ -0,0 +1,269 @@
+#include "./cubeandconquer.h"
+#include "./mpiformula.h"
+#include "../cdcl/cdclsolver.h"
+#include "../general/log.h"
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <cmath>
+
+namespace {
+
+// The cdcl engine splits a cube this many decisions deeper when asked to
+const int SPLIT_DEPTH = 2;
+
+// Initial cubes per worker, so faster workers can take more of them
+const int CUBES_PER_WORKER = 8;
+
+// The stop callback asks MPI for messages only every this many calls
+const unsigned POLL_INTERVAL = 64;
+
+using Clock = chrono::steady_clock;
+
+Clock::time_point deadlineAfter(double seconds) {
+    if (seconds <= 0) return Clock::time_point::max();
+    return Clock::now() + chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds));
+}
+
+void sendInts(const vector<int>& data, int destination, int tag, MPI_Comm comm) {
+    MPI_Send(data.data(), static_cast<int>(data.size()), MPI_INT, destination, tag, comm);
+}
+
+// Receives the message status describes
+vector<int> receiveInts(const MPI_Status& status, MPI_Comm comm) {
+    int count = 0;
+    MPI_Get_count(&status, MPI_INT, &count);
+    vector<int> data(count);
+    MPI_Recv(data.data(), count, MPI_INT, status.MPI_SOURCE, status.MPI_TAG, comm, MPI_STATUS_IGNORE);
+    return data;
+}
+
+// Split messages start with 1 if the sender gave up its cube for them and
+// 0 if it keeps searching the rest, then hold the cubes back to back, each
+// preceded by its length
+vector<int> packCubes(bool replaced, const vector<vector<int>>& cubes) {
+    vector<int> data = {replaced ? 1 : 0};
+    for (const vector<int>& cube : cubes) {
+        data.push_back(static_cast<int>(cube.size()));
+        data.insert(data.end(), cube.begin(), cube.end());
+    }
+    return data;
+}
+
+void unpackCubes(const vector<int>& data, deque<vector<int>>& queue) {
+    for (size_t i = 1; i < data.size(); i += data[i] + 1) {
+        queue.emplace_back(data.begin() + i + 1, data.begin() + i + 1 + data[i]);
+    }
+}
+
+// Solves cubes for the root until it sends the stop message, which holds
+// the winner and the final status. A split request from the root is
+// answered with a split message: the dpll engine gives away its lowest
+// open branch and goes on, the cdcl engine splits its cube and drops it.
+vector<int> runWorker(shared_ptr<const Formula> formula, const CubeOptions& options, Clock::time_point deadline,
+                      MPI_Comm comm) {
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+
+    DPLLSolver dpll(formula);  // splits cubes, and solves them with the dpll engine
+    dpll.setHeuristic(options.heuristic);
+    unique_ptr<CDCLSolver> cdcl;
+    if (options.engine == "cdcl") cdcl = make_unique<CDCLSolver>(formula);
+
+    bool splitDue = false;
+    auto pending = [&](int tag) {
+        int flag = 0;
+        MPI_Iprobe(0, tag, comm, &flag, MPI_STATUS_IGNORE);
+        return flag != 0;
+    };
+    auto takeRequest = [&]() { MPI_Recv(nullptr, 0, MPI_INT, 0, TAG_SPLIT, comm, MPI_STATUS_IGNORE); };
+
+    unsigned polls = 0;
+    auto stopped = [&]() {
+        if (Clock::now() >= deadline) return true;
+        if (++polls % POLL_INTERVAL != 0) return false;
+        if (pending(TAG_STOP)) return true;
+        // Only the cdcl engine stops to split
+        splitDue = cdcl && pending(TAG_SPLIT);
+        return splitDue;
+    };
+    dpll.setTerminate(stopped);
+    if (cdcl) cdcl->setTerminate(stopped);
+
+    unsigned exportPolls = 0;
+    auto exportWanted = [&]() { return ++exportPolls % POLL_INTERVAL == 0 && pending(TAG_SPLIT); };
+    auto exportBranch = [&](const vector<int>& branch) {
+        takeRequest();
+        sendInts(packCubes(false, {branch}), 0, TAG_SPLIT, comm);
+    };
+    if (!cdcl) dpll.setBranchExport(exportWanted, exportBranch);
+
+    vector<int> model;
+    while (true) {
+        MPI_Status status;
+        MPI_Probe(0, MPI_ANY_TAG, comm, &status);
+        if (status.MPI_TAG == TAG_STOP) {
+            vector<int> stop = receiveInts(status, comm);
+            if (stop[0] == rank && stop[1] == static_cast<int>(SolveResult::Sat)) sendInts(model, 0, TAG_MODEL, comm);
+            return stop;
+        }
+        vector<int> cube = receiveInts(status, comm);
+        // A request that came after the last cube was finished
+        if (status.MPI_TAG == TAG_SPLIT) continue;
+
+        splitDue = false;
+        SolveResult outcome = cdcl ? cdcl->solve(cube) : dpll.solveCube(cube);
+        if (outcome == SolveResult::Sat) model = cdcl ? cdcl->getAssignment() : dpll.getAssignment();
+
+        if (outcome == SolveResult::Unknown && splitDue) {
+            vector<vector<int>> parts;
+            outcome = dpll.makeCubes(cube, SPLIT_DEPTH, parts);
+            if (outcome == SolveResult::Sat) model = dpll.getAssignment();
+            if (outcome == SolveResult::Unknown) {
+                LOG_DEBUG("Rank " << rank << " splits a cube of " << cube.size() << " literals into " << parts.size());
+                takeRequest();
+                sendInts(packCubes(true, parts), 0, TAG_SPLIT, comm);
+                continue;
+            }
+        }
+        if (outcome == SolveResult::Sat && !formula->isModel(model)) {
+            LOG_ERROR("Rank " << rank << " found an assignment that is not a model");
+            outcome = SolveResult::Unknown;
+        }
+        sendInts({static_cast<int>(outcome)}, 0, TAG_RESULT, comm);
+    }
+}
+
+} // namespace
+
+CubeResult runCubeAndConquer(shared_ptr<const Formula> formula, const CubeOptions& options, MPI_Comm comm) {
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    Clock::time_point deadline = deadlineAfter(options.timeout);
+
+    CubeResult result;
+    if (rank != 0) {
+        vector<int> stop = runWorker(formula, options, deadline, comm);
+        result.winner = stop[0];
+        result.status = static_cast<SolveResult>(stop[1]);
+        return result;
+    }
+
+    DPLLSolver splitter(formula);
+    splitter.setHeuristic(options.heuristic);
+    splitter.setTerminate([deadline]() { return Clock::now() >= deadline; });
+
+    if (size == 1) {
+        result.status = splitter.solveCube(vector<int>());
+        if (result.status == SolveResult::Sat) {
+            result.winner = 0;
+            result.model = splitter.getAssignment();
+        }
+        return result;
+    }
+
+    int depth = options.depth;
+    if (depth <= 0) depth = static_cast<int>(ceil(log2(static_cast<double>(CUBES_PER_WORKER) * (size - 1))));
+    vector<vector<int>> initial;
+    result.status = splitter.makeCubes(vector<int>(), depth, initial);
+    if (result.status == SolveResult::Sat) {
+        result.winner = 0;
+        result.model = splitter.getAssignment();
+    }
+    deque<vector<int>> queue(initial.begin(), initial.end());
+    LOG_INFO("Cube and conquer: " << queue.size() << " cubes of depth " << depth << " for " << size - 1 << " workers");
+
+    vector<int> idle;
+    for (int worker = size - 1; worker >= 1; worker--) idle.push_back(worker);
+    vector<bool> working(size, false);
+    vector<Clock::time_point> started(size);
+    vector<bool> asked(size, false);  // split request not answered yet
+    int requests = 0;
+    int busy = 0;
+    // Cubes shorter than this are not worth splitting
+    auto splitAfter = chrono::duration_cast<Clock::duration>(chrono::duration<double>(options.splitAfter));
+    bool incomplete = false;  // some cube ended without an answer
+    bool stopping = false;    // answers no longer count
+
+    auto receive = [&](const MPI_Status& status) {
+        vector<int> data = receiveInts(status, comm);
+        int worker = status.MPI_SOURCE;
+        if (asked[worker]) requests--;
+        asked[worker] = false;
+        if (status.MPI_TAG == TAG_SPLIT) {
+            result.splits++;
+            unpackCubes(data, queue);
+            if (data[0] == 0) return;  // the worker is still busy
+        } else if (data[0] == static_cast<int>(SolveResult::Sat)) {
+            if (!stopping && result.winner < 0) {
+                result.winner = worker;
+                result.status = SolveResult::Sat;
+            }
+        } else if (data[0] == static_cast<int>(SolveResult::Unsat)) {
+            result.cubes++;
+        } else {
+            incomplete = true;
+        }
+        busy--;
+        working[worker] = false;
+        idle.push_back(worker);
+    };
+
+    if (result.status == SolveResult::Unknown) {
+        while (!incomplete && result.status == SolveResult::Unknown && (busy > 0 || !queue.empty())) {
+            while (!queue.empty() && !idle.empty()) {
+                int worker = idle.back();
+                idle.pop_back();
+                sendInts(queue.front(), worker, TAG_CUBE, comm);
+                queue.pop_front();
+                started[worker] = Clock::now();
+                working[worker] = true;
+                busy++;
+            }
+            // Out of cubes: ask as many long-running workers for more as are idle
+            if (queue.empty() && static_cast<int>(idle.size()) > requests) {
+                Clock::time_point now = Clock::now();
+                for (int worker = 1; worker < size && static_cast<int>(idle.size()) > requests; worker++) {
+                    if (!working[worker] || asked[worker] || now - started[worker] < splitAfter) continue;
+                    MPI_Send(nullptr, 0, MPI_INT, worker, TAG_SPLIT, comm);
+                    asked[worker] = true;
+                    requests++;
+                }
+            }
+            if (Clock::now() >= deadline) {
+                incomplete = true;
+                break;
+            }
+            // Polled rather than blocking, so the deadline is kept
+            int pending = 0;
+            MPI_Status status;
+            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &pending, &status);
+            if (pending) {
+                receive(status);
+            } else {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        }
+        if (!incomplete && result.status == SolveResult::Unknown) result.status = SolveResult::Unsat;
+    }
+
+    // Stop everyone, then take the last report of each busy worker
+    stopping = true;
+    int stop[2] = {result.winner, static_cast<int>(result.status)};
+    for (int worker = 1; worker < size; worker++) MPI_Send(stop, 2, MPI_INT, worker, TAG_STOP, comm);
+    // The winner's model may come in between the other reports
+    bool modelDue = result.winner > 0;
+    while (busy > 0 || modelDue) {
+        MPI_Status status;
+        MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &status);
+        if (status.MPI_TAG == TAG_MODEL) {
+            result.model = receiveInts(status, comm);
+            modelDue = false;
+        } else {
+            receive(status);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,46 @@
+#ifndef CUBEANDCONQUER_H
+#define CUBEANDCONQUER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <mpi.h>
+#include "../general/formula.h"
+#include "../general/satsolver.h"
+#include "../dpll/dpllsolver.h"
+
+#pragma once
+
+using namespace std;
+
+struct CubeOptions {
+    string engine = "dpll";  // solves the cubes: dpll, or cdcl (assumptions; learnt clauses kept between cubes)
+    BranchHeuristic heuristic = BranchHeuristic::JeroslowWang;  // for splitting and the dpll engine
+    int depth = 0;           // decisions per initial cube, 0 to choose from the number of workers
+    double splitAfter = 0.5; // seconds a cube runs before the root may ask to split it
+    double timeout = 0;      // seconds for the whole run, 0 for none
+};
+
+struct CubeResult {
+    SolveResult status = SolveResult::Unknown;
+    int winner = -1;      // rank that found the model, -1 otherwise
+    vector<int> model;    // on the root, after Sat
+    size_t cubes = 0;     // cubes refuted by the workers
+    size_t splits = 0;    // split requests answered with new cubes
+};
+
+// Collective over comm. The root splits the formula into cubes along the
+// first decisions of DPLLSolver::chooseLiteral() (DPLLSolver::makeCubes)
+// and hands them out one at a time to the other ranks as they become
+// idle. A worker refutes its cube or finds a model. When the queue runs
+// dry while workers wait, the root asks workers whose cube has run for
+// splitAfter seconds for more: the dpll engine gives away the untried
+// branch of its lowest open decision (DPLLSolver::setBranchExport) and
+// searches on, the cdcl engine splits its cube two decisions deeper and
+// returns the parts. The formula is UNSAT once every cube is refuted; the
+// first model ends the run. Every rank returns the same status and winner.
+// With a single rank the root solves the formula itself.
+CubeResult runCubeAndConquer(shared_ptr<const Formula> formula, const CubeOptions& options, MPI_Comm comm);
+
+#endif // CUBEANDCONQUER_H
@@ -0,0 +1,67 @@
+#include "./mpiformula.h"
+#include "../general/log.h"
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+namespace {
+
+// MPI counts are ints; large formulas go in pieces
+const size_t CHUNK = size_t(1) << 28;
+
+void broadcastString(string& text, MPI_Comm comm, int root) {
+    uint64_t length = text.size();
+    MPI_Bcast(&length, 1, MPI_UINT64_T, root, comm);
+    text.resize(length);
+    if (length > 0) MPI_Bcast(text.data(), static_cast<int>(length), MPI_CHAR, root, comm);
+}
+
+} // namespace
+
+shared_ptr<const Formula> broadcastFormula(const string& filename, MPI_Comm comm, int root) {
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+
+    shared_ptr<const Formula> formula;
+    string error;
+    if (rank == root) {
+        try {
+            formula = Formula::load(filename);
+        } catch (const exception& e) {
+            error = e.what();
+            if (error.empty()) error = "Failed to load " + filename;
+        }
+    }
+    broadcastString(error, comm, root);
+    if (!error.empty()) throw runtime_error(error);
+
+    // Problem line counts and literal count, then the literals
+    int64_t header[3] = {0, 0, 0};
+    span<const int> literals;
+    if (rank == root) {
+        literals = formula->getLiterals();
+        header[0] = formula->getNumLiterals();
+        header[1] = formula->getNumClauses();
+        header[2] = static_cast<int64_t>(literals.size());
+    }
+    MPI_Bcast(header, 3, MPI_INT64_T, root, comm);
+
+    vector<int> received;
+    int* data = const_cast<int*>(literals.data());
+    if (rank != root) {
+        received.resize(static_cast<size_t>(header[2]));
+        data = received.data();
+    }
+    for (size_t offset = 0; offset < static_cast<size_t>(header[2]); offset += CHUNK) {
+        size_t count = min(CHUNK, static_cast<size_t>(header[2]) - offset);
+        MPI_Bcast(data + offset, static_cast<int>(count), MPI_INT, root, comm);
+    }
+
+    if (rank != root) {
+        formula = make_shared<const Formula>(static_cast<int>(header[0]), static_cast<int>(header[1]), move(received));
+    }
+    LOG_DEBUG("Rank " << rank << " has the formula: " << formula->getNumVars() << " variables, "
+                      << formula->getNumParsedClauses() << " clauses");
+    return formula;
+}
@@ -0,0 +1,28 @@
+#ifndef MPIFORMULA_H
+#define MPIFORMULA_H
+
+#include <string>
+#include <memory>
+#include <mpi.h>
+#include "../general/formula.h"
+
+#pragma once
+
+using namespace std;
+
+// Message tags of the distributed modes
+enum MpiTag {
+    TAG_RESULT = 1,  // worker -> root: outcome of a search
+    TAG_STOP = 2,    // root -> worker: stop, with the final answer
+    TAG_MODEL = 3,   // worker -> root: the satisfying assignment
+    TAG_CUBE = 4,    // root -> worker: a cube to solve
+    TAG_SPLIT = 5    // root -> worker: a request for work; worker -> root: cubes split off
+};
+
+// Collective: the root loads the file (CNF or snapshot) and sends the
+// clauses to every other rank, so only the root needs to see the file.
+// Every rank gets its own Formula with the same hash. If the root cannot
+// load the file, every rank throws runtime_error with the root's message.
+shared_ptr<const Formula> broadcastFormula(const string& filename, MPI_Comm comm, int root = 0);
+
+#endif // MPIFORMULA_H
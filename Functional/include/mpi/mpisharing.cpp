@@ -0,0 +1,102 @@
+#include "./mpisharing.h"
+#include "../general/log.h"
+
+namespace {
+
+// Records a rank that never imports keeps, in rounds' worth
+const size_t KEPT_ROUNDS = 4;
+
+} // namespace
+
+MpiClauseSharing::MpiClauseSharing(MPI_Comm parent, double seconds, const SharingLimits& limits)
+    : ClauseSharing(limits) {
+    MPI_Comm_dup(parent, &comm);
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    interval = chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds));
+    nextRound = Clock::now() + interval;
+    headers.resize(2 * static_cast<size_t>(size));
+    counts.resize(size);
+    displacements.resize(size);
+}
+
+MpiClauseSharing::~MpiClauseSharing() {
+    finish();
+    MPI_Comm_free(&comm);
+}
+
+void MpiClauseSharing::progress() {
+    advance(false);
+}
+
+void MpiClauseSharing::finish() {
+    finishing = true;
+    while (!closed) advance(true);
+}
+
+void MpiClauseSharing::exchange() {
+    progress();
+    incoming.insert(incoming.end(), received.begin(), received.end());
+    received.clear();
+}
+
+void MpiClauseSharing::startRound() {
+    sent.clear();
+    outgoing.drain(sent);
+    header[0] = static_cast<int>(sent.size());
+    header[1] = finishing ? 1 : 0;
+    MPI_Iallgather(header, 2, MPI_INT, headers.data(), 2, MPI_INT, comm, &request);
+    state = Round::Counting;
+}
+
+// Moves the round on as far as it goes without waiting, or to its end
+// when block is set; a new round starts when one is due
+void MpiClauseSharing::advance(bool block) {
+    if (closed) return;
+    if (state == Round::Idle) {
+        if (!block && Clock::now() < nextRound) return;
+        startRound();
+    }
+    while (state != Round::Idle) {
+        int complete = 1;
+        if (block) {
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+        } else {
+            MPI_Test(&request, &complete, MPI_STATUS_IGNORE);
+        }
+        if (!complete) return;
+
+        if (state == Round::Counting) {
+            int total = 0;
+            for (int i = 0; i < size; i++) {
+                counts[i] = headers[2 * i];
+                displacements[i] = total;
+                total += counts[i];
+            }
+            gathered.resize(total);
+            MPI_Iallgatherv(sent.data(), header[0], MPI_INT, gathered.data(), counts.data(), displacements.data(),
+                            MPI_INT, comm, &request);
+            state = Round::Gathering;
+        } else {
+            endRound();
+        }
+    }
+}
+
+void MpiClauseSharing::endRound() {
+    state = Round::Idle;
+    rounds++;
+    nextRound = Clock::now() + interval;
+
+    if (received.size() > KEPT_ROUNDS * limits.roundLiterals * static_cast<size_t>(size)) received.clear();
+    for (int i = 0; i < size; i++) {
+        if (headers[2 * i + 1]) closed = true;
+        if (i == rank) continue;
+        received.insert(received.end(), gathered.begin() + displacements[i],
+                        gathered.begin() + displacements[i] + counts[i]);
+    }
+    if (closed) {
+        LOG_DEBUG("Rank " << rank << " leaves clause sharing after " << rounds << " rounds: " << getExported()
+                          << " clauses exported, " << getImported() << " imported, " << getDropped() << " dropped");
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef MPISHARING_H
+#define MPISHARING_H
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <mpi.h>
+#include "../general/clausesharing.h"
+
+#pragma once
+
+using namespace std;
+
+// Clause exchange between MPI ranks in rounds: every rank puts in what its
+// solver has buffered and gets what all the others put in (MPI_Iallgather
+// of the sizes, then MPI_Iallgatherv of the records). A rank starts its
+// next round interval seconds after the last one ended. Rounds never block
+// the search; they are driven by progress(), which every rank has to call
+// regularly (from its terminate callback) whether its solver shares
+// clauses or not, and they run on a duplicate of comm so they never mix
+// with the caller's messages.
+//
+// finish() ends the exchange for this rank and blocks until every rank
+// has taken part in the round that carries the news, which is the last
+// round for all of them. Each rank must call it (directly or through the
+// destructor) at a point where the others are still able to progress.
+class MpiClauseSharing : public ClauseSharing {
+public:
+    // Collective over comm
+    MpiClauseSharing(MPI_Comm comm, double interval = 0.5, const SharingLimits& limits = SharingLimits());
+    ~MpiClauseSharing() override;
+
+    void progress();
+    void finish();
+
+    uint64_t getRounds() const { return rounds; }
+
+protected:
+    void exchange() override;
+
+private:
+    enum class Round { Idle, Counting, Gathering };
+
+    void startRound();
+    void advance(bool block);
+    void endRound();
+
+    using Clock = chrono::steady_clock;
+
+    MPI_Comm comm = MPI_COMM_NULL;
+    int rank = 0;
+    int size = 1;
+    Clock::duration interval;
+    Clock::time_point nextRound;
+
+    Round state = Round::Idle;
+    MPI_Request request = MPI_REQUEST_NULL;
+    int header[2] = {0, 0};      // records sent, finishing
+    vector<int> headers;         // header of every rank
+    vector<int> counts;
+    vector<int> displacements;
+    vector<int> sent;
+    vector<int> gathered;
+    vector<int> received;        // other ranks' records, not yet imported
+    bool finishing = false;
+    bool closed = false;
+    uint64_t rounds = 0;
+};
+
+#endif // MPISHARING_H
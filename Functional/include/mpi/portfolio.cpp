@@ -0,0 +1,156 @@
+#include "./portfolio.h"
+#include "./mpiformula.h"
+#include "./mpisharing.h"
+#include "../general/log.h"
+#include <chrono>
+#include <thread>
+#include <functional>
+
+namespace {
+
+// The stop callback asks MPI for messages only every this many calls
+const unsigned POLL_INTERVAL = 64;
+
+// Totals of the sharing statistics on the root; collective
+void reduceSharing(const MpiClauseSharing* sharing, PortfolioResult& result, MPI_Comm comm) {
+    uint64_t counts[2] = {sharing->getExported(), sharing->getImported()};
+    uint64_t totals[2] = {0, 0};
+    MPI_Reduce(counts, totals, 2, MPI_UINT64_T, MPI_SUM, 0, comm);
+    result.exported = totals[0];
+    result.imported = totals[1];
+}
+
+} // namespace
+
+PortfolioResult runPortfolio(shared_ptr<const Formula> formula, double timeout, MPI_Comm comm,
+                             double shareInterval) {
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    unique_ptr<MpiClauseSharing> sharing;
+    if (shareInterval > 0 && size > 1) sharing = make_unique<MpiClauseSharing>(comm, shareInterval);
+
+    PortfolioEntry entry = portfolioEntry(rank, *formula);
+    LOG_INFO("Rank " << rank << ": " << entry.describe());
+
+    auto deadline = chrono::steady_clock::time_point::max();
+    if (timeout > 0) {
+        deadline = chrono::steady_clock::now() +
+                   chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(timeout));
+    }
+
+    PortfolioResult result;
+    unsigned polls = 0;
+
+    if (rank != 0) {
+        // Posted before the search, so the root's stop message is always matched
+        int stop[2] = {-1, 0};
+        MPI_Request stopRequest;
+        MPI_Irecv(stop, 2, MPI_INT, 0, TAG_STOP, comm, &stopRequest);
+        auto stopped = [&]() {
+            if (chrono::steady_clock::now() >= deadline) return true;
+            if (++polls % POLL_INTERVAL != 0) return false;
+            if (sharing) sharing->progress();
+            int done = 0;
+            MPI_Test(&stopRequest, &done, MPI_STATUS_IGNORE);
+            return done != 0;
+        };
+
+        vector<int> model;
+        SolveResult outcome = solveEntry(entry, formula, stopped, sharing.get(), model);
+        if (outcome == SolveResult::Sat && !formula->isModel(model)) {
+            LOG_ERROR("Rank " << rank << " (" << entry.describe() << ") reported SAT without a valid model");
+            outcome = SolveResult::Unknown;
+        }
+
+        // Every worker reports exactly once, then waits for the verdict
+        int code = static_cast<int>(outcome);
+        MPI_Send(&code, 1, MPI_INT, 0, TAG_RESULT, comm);
+        if (sharing) {
+            // Sharing rounds go on until the verdict, so no rank waits on this one
+            int done = 0;
+            MPI_Test(&stopRequest, &done, MPI_STATUS_IGNORE);
+            while (!done) {
+                sharing->progress();
+                this_thread::sleep_for(chrono::milliseconds(1));
+                MPI_Test(&stopRequest, &done, MPI_STATUS_IGNORE);
+            }
+            sharing->finish();
+            reduceSharing(sharing.get(), result, comm);
+        } else {
+            MPI_Wait(&stopRequest, MPI_STATUS_IGNORE);
+        }
+        result.winner = stop[0];
+        result.status = static_cast<SolveResult>(stop[1]);
+        if (result.winner == rank && result.status == SolveResult::Sat) {
+            MPI_Send(model.data(), static_cast<int>(model.size()), MPI_INT, 0, TAG_MODEL, comm);
+        }
+        return result;
+    }
+
+    // Root: solves as well, and takes the workers' reports in between
+    int code = 0;
+    int received = 0;
+    MPI_Request resultRequest = MPI_REQUEST_NULL;
+    if (size > 1) MPI_Irecv(&code, 1, MPI_INT, MPI_ANY_SOURCE, TAG_RESULT, comm, &resultRequest);
+    auto collect = [&](bool block) {
+        while (received < size - 1) {
+            int done = 1;
+            MPI_Status status;
+            if (block) {
+                MPI_Wait(&resultRequest, &status);
+            } else {
+                MPI_Test(&resultRequest, &done, &status);
+                if (!done) return;
+            }
+            received++;
+            if (code != static_cast<int>(SolveResult::Unknown) && result.winner < 0) {
+                result.winner = status.MPI_SOURCE;
+                result.status = static_cast<SolveResult>(code);
+            }
+            if (received < size - 1) MPI_Irecv(&code, 1, MPI_INT, MPI_ANY_SOURCE, TAG_RESULT, comm, &resultRequest);
+            if (block) return;
+        }
+    };
+    auto stopped = [&]() {
+        if (chrono::steady_clock::now() >= deadline) return true;
+        if (++polls % POLL_INTERVAL != 0) return false;
+        if (sharing) sharing->progress();
+        collect(false);
+        return result.winner >= 0;
+    };
+
+    vector<int> model;
+    SolveResult outcome = solveEntry(entry, formula, stopped, sharing.get(), model);
+    if (outcome == SolveResult::Sat && !formula->isModel(model)) {
+        LOG_ERROR("Rank 0 (" << entry.describe() << ") reported SAT without a valid model");
+        outcome = SolveResult::Unknown;
+    }
+    if (result.winner < 0 && outcome != SolveResult::Unknown) {
+        result.winner = 0;
+        result.status = outcome;
+        result.model = move(model);
+    }
+
+    // Without an answer yet, wait for the workers until one has it or all gave up
+    while (result.winner < 0 && received < size - 1) collect(true);
+
+    int stop[2] = {result.winner, static_cast<int>(result.status)};
+    for (int worker = 1; worker < size; worker++) MPI_Send(stop, 2, MPI_INT, worker, TAG_STOP, comm);
+    while (received < size - 1) collect(true);
+    if (sharing) {
+        sharing->finish();
+        reduceSharing(sharing.get(), result, comm);
+    }
+
+    if (result.winner > 0 && result.status == SolveResult::Sat) {
+        MPI_Status status;
+        int count = 0;
+        MPI_Probe(result.winner, TAG_MODEL, comm, &status);
+        MPI_Get_count(&status, MPI_INT, &count);
+        result.model.resize(count);
+        MPI_Recv(result.model.data(), count, MPI_INT, result.winner, TAG_MODEL, comm, MPI_STATUS_IGNORE);
+    }
+    return result;
+}
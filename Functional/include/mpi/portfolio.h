@@ -0,0 +1,39 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <mpi.h>
+#include "../general/formula.h"
+#include "../general/satsolver.h"
+#include "../portfolio/portfolioentry.h"
+
+#pragma once
+
+using namespace std;
+
+struct PortfolioResult {
+    SolveResult status = SolveResult::Unknown;
+    int winner = -1;     // rank that answered, -1 if none did
+    vector<int> model;   // on the root, after Sat
+    uint64_t exported = 0;  // clauses shared, summed over the ranks (root only)
+    uint64_t imported = 0;
+};
+
+// Collective over comm: every rank solves the same formula with its own
+// configuration (portfolioEntry(rank)) until one of them answers or
+// timeout seconds (0 for none) pass. The root collects the outcomes; the
+// first definitive one is sent to every rank, which then stops. A SAT answer only counts if its
+// assignment satisfies every clause, so solvers without a usable model
+// (resolution) can only win with UNSAT. Every rank returns the same
+// status and winner.
+//
+// With shareInterval > 0 the CDCL ranks exchange short, low-LBD learnt
+// clauses every shareInterval seconds (see mpi/mpisharing.h); the other
+// ranks take part in the rounds without clauses of their own.
+PortfolioResult runPortfolio(shared_ptr<const Formula> formula, double timeout, MPI_Comm comm,
+                             double shareInterval = 0.5);
+
+#endif // PORTFOLIO_H
@@ -1,54 +1,305 @@
 #include "./DIMACSParser.h"
-#include <fstream>
-#include <sstream>
+#include "./mappedfile.h"
+#include "./decompress.h"
 #include <iostream>
 #include <stdexcept>
+#include <memory>
+#include <climits>
+#include <algorithm>
+#include <thread>
+#include <exception>
+#include "../general/log.h"
 
-DIMACSParser::DIMACSParser(const string& filename) {
-    ifstream inFile(filename);
-    if (!inFile.is_open()) {
+DIMACSParser::DIMACSParser(const string& filename, unsigned threads) {
+    unique_ptr<MappedFile> file;
+    try {
+        file = make_unique<MappedFile>(filename);
+    } catch (const runtime_error&) {
         cerr << "Error: Could not open file " << filename << endl;
         throw runtime_error("Failed to open DIMACS file: " + filename);
     }
+    read(file->data(), file->size(), threads);
+}
 
-    string line;
-    while (getline(inFile, line)) {
-        if (line.empty() || line[0] == 'c') {
-            continue; // Skip comments
-        }
-        if (line[0] == 'p') {
-            // Parse the problem line
-            stringstream ss(line);
-            string tmp;
-            ss >> tmp >> tmp >> numLiterals >> numClauses;
-            cout << "Parsed problem line: " << numLiterals << " literals, " << numClauses << " clauses" << endl;
+DIMACSParser::DIMACSParser(const char* data, size_t size, unsigned threads) {
+    read(data, size, threads);
+}
+
+void DIMACSParser::read(const char* data, size_t size, unsigned threads) {
+    // Compressed input is decompressed on a second thread while the
+    // blocks it produces are scanned
+    Compression compression = detectCompression(data, size);
+    if (compression != Compression::None) {
+        DecompressStream stream(compression, data, size);
+        parseStream(stream);
+        return;
+    }
+    parse(data, data + size, threads);
+}
+
+namespace {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Start of a buffer and its position in the (decompressed) input, so
+// errors report file offsets
+struct Origin {
+    const char* data;
+    size_t offset;
+};
+
+[[noreturn]] void syntaxError(const char* what, const char* at, const Origin& origin) {
+    size_t position = origin.offset + static_cast<size_t>(at - origin.data);
+    throw runtime_error(string("DIMACS syntax error: ") + what + " at byte " + to_string(position));
+}
+
+// Signed decimal integer starting at p; p is left after its last digit
+int scanInt(const char*& p, const char* end, const Origin& origin) {
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    if (p >= end || !isDigit(*p)) syntaxError("expected a number", p, origin);
+
+    long long value = 0;
+    while (p < end && isDigit(*p)) {
+        value = value * 10 + (*p - '0');
+        if (value > INT_MAX) syntaxError("number out of range", p, origin);
+        p++;
+    }
+    return static_cast<int>(negative ? -value : value);
+}
+
+inline void skipLine(const char*& p, const char* end) {
+    while (p < end && *p != '\n') p++;
+}
+
+// Leading comments and the problem line: p cnf <variables> <clauses>.
+// Returns false if [p, end) held nothing but comments, so the header may
+// still follow in the next buffer.
+bool scanHeader(const char*& p, const char* end, const Origin& origin, int& variables, int& clauses) {
+    while (p < end) {
+        if (isSpace(*p)) {
+            p++;
+        } else if (*p == 'c') {
+            skipLine(p, end);
         } else {
-            // Parse a clause
-            stringstream ss(line);
-            int literal;
-            vector<int> clause;
-            while (ss >> literal && literal != 0) {
-                clause.push_back(literal); // Add literals in order
+            break;
+        }
+    }
+    if (p == end) return false;
+    if (*p == 'p') {
+        p++;
+        while (p < end && isSpace(*p)) p++;
+        while (p < end && !isSpace(*p)) p++;  // format word
+        while (p < end && isSpace(*p)) p++;
+        variables = scanInt(p, end, origin);
+        while (p < end && isSpace(*p)) p++;
+        clauses = scanInt(p, end, origin);
+        LOG_DEBUG("Parsed problem line: " << variables << " literals, " << clauses << " clauses");
+    }
+    return true;
+}
+
+// Clauses of [p, end) appended to out, each closed by 0. start is the
+// position in out of the clause still open, which the next buffer may
+// continue; closeClause() ends it after the last buffer. Returns false if
+// the '%' end marker was reached, in which case nothing after it belongs
+// to the formula.
+bool scanClauses(const char* p, const char* end, const Origin& origin, vector<int>& out, size_t& clauses, size_t& start) {
+    bool more = true;
+
+    while (p < end) {
+        char c = *p;
+        if (isSpace(c)) {
+            p++;
+        } else if (c == 'c' || c == 'p') {
+            // Comments, and problem lines out of place, run to end of line
+            skipLine(p, end);
+        } else if (c == '%') {
+            // End marker used by the SATLIB benchmark files
+            more = false;
+            break;
+        } else if (c == '-' || isDigit(c)) {
+            int literal = scanInt(p, end, origin);
+            if (p < end && !isSpace(*p)) syntaxError("unexpected character after number", p, origin);
+            if (literal != 0) {
+                out.push_back(literal);
+            } else if (out.size() > start) {
+                out.push_back(0);
+                clauses++;
+                LOG_TRACE("Parsed clause: " << satlog::join(out.begin() + start, out.end()));
+                start = out.size();
             }
-            if (!clause.empty()) {
-                clauses.push_back(clause);
-                cout << "Parsed clause: ";
-                for (int lit : clause) {
-                    cout << lit << " ";
-                }
-                cout << "0" << endl;
+        } else {
+            syntaxError("unexpected character", p, origin);
+        }
+    }
+
+    return more;
+}
+
+// Last clause without its terminating 0
+void closeClause(vector<int>& out, size_t& clauses, size_t start) {
+    if (out.size() > start) {
+        out.push_back(0);
+        clauses++;
+    }
+}
+
+// First clause boundary at or after p: the position just behind a 0 token.
+// The search starts on a fresh line so comment lines are recognised; a 0
+// token outside a comment or problem line always ends a clause.
+const char* nextClauseBoundary(const char* p, const char* end) {
+    skipLine(p, end);
+    while (p < end) {
+        char c = *p;
+        if (isSpace(c)) {
+            p++;
+        } else if (c == 'c' || c == 'p') {
+            skipLine(p, end);
+        } else if (c == '%') {
+            return end;
+        } else {
+            const char* token = p;
+            while (p < end && !isSpace(*p)) p++;
+            if (p - token == 1 && *token == '0') return p;
+        }
+    }
+    return end;
+}
+
+// Bytes per thread below which splitting the input does not pay off
+const size_t MIN_CHUNK_BYTES = 4 << 20;
+
+} // namespace
+
+void DIMACSParser::parse(const char* p, const char* end, unsigned threads) {
+    const Origin origin{p, 0};
+    scanHeader(p, end, origin, numLiterals, numClauses);
+
+    // Every literal takes at least its digits and a separator
+    size_t digits = to_string(max(numLiterals, 1)).size();
+    auto estimate = [digits](size_t bytes) { return bytes / (digits + 1); };
+
+    size_t bytes = static_cast<size_t>(end - p);
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    threads = static_cast<unsigned>(min<size_t>(threads, bytes / MIN_CHUNK_BYTES));
+
+    if (threads <= 1) {
+        literals.reserve(estimate(bytes) + numClauses);
+        size_t start = 0;
+        scanClauses(p, end, origin, literals, parsedClauses, start);
+        closeClause(literals, parsedClauses, start);
+        return;
+    }
+
+    // Cut the body at clause boundaries into one chunk per thread
+    vector<const char*> bounds(threads + 1);
+    bounds[0] = p;
+    for (unsigned i = 1; i < threads; i++) {
+        const char* nominal = p + bytes / threads * i;
+        bounds[i] = max(bounds[i - 1], nextClauseBoundary(nominal, end));
+    }
+    bounds[threads] = end;
+
+    // Each thread scans its chunk into its own buffer
+    vector<vector<int>> chunks(threads);
+    vector<size_t> chunkClauses(threads, 0);
+    vector<char> chunkComplete(threads, 1);
+    vector<exception_ptr> errors(threads);
+    vector<thread> workers;
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; i++) {
+        workers.emplace_back([&, i]() {
+            try {
+                chunks[i].reserve(estimate(bounds[i + 1] - bounds[i]));
+                size_t start = 0;
+                chunkComplete[i] = scanClauses(bounds[i], bounds[i + 1], origin, chunks[i], chunkClauses[i], start);
+                closeClause(chunks[i], chunkClauses[i], start);
+            } catch (...) {
+                errors[i] = current_exception();
             }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    // Concatenate in file order; nothing after a '%' marker counts, and an
+    // error is reported only if it lies before that marker
+    unsigned used = 0;
+    vector<size_t> offsets(threads + 1, 0);
+    while (used < threads) {
+        if (errors[used]) rethrow_exception(errors[used]);
+        offsets[used + 1] = offsets[used] + chunks[used].size();
+        parsedClauses += chunkClauses[used];
+        if (!chunkComplete[used++]) break;
+    }
+
+    literals.resize(offsets[used]);
+    workers.clear();
+    for (unsigned i = 0; i < used; i++) {
+        workers.emplace_back([&, i]() {
+            copy(chunks[i].begin(), chunks[i].end(), literals.begin() + offsets[i]);
+            vector<int>().swap(chunks[i]);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+// Blocks end on line breaks, so only a clause can continue from one block
+// into the next; the header may only be preceded by comment-only blocks
+void DIMACSParser::parseStream(DecompressStream& stream) {
+    vector<char> block;
+    size_t offset = 0;
+    size_t start = 0;
+    bool inHeader = true;
+
+    while (stream.next(block)) {
+        const char* p = block.data();
+        const char* end = p + block.size();
+        const Origin origin{p, offset};
+        offset += block.size();
+
+        if (inHeader) {
+            inHeader = !scanHeader(p, end, origin, numLiterals, numClauses);
+            if (inHeader) continue;
+            // The uncompressed size is unknown: room for 3 literals a clause
+            literals.reserve(static_cast<size_t>(max(numClauses, 0)) * 4);
+        }
+        if (!scanClauses(p, end, origin, literals, parsedClauses, start)) break;
+    }
+    closeClause(literals, parsedClauses, start);
+}
+
+vector<vector<int>> DIMACSParser::getClauses() const {
+    vector<vector<int>> clauses;
+    clauses.reserve(parsedClauses);
+    vector<int> clause;
+    for (int lit : literals) {
+        if (lit == 0) {
+            clauses.push_back(clause);
+            clause.clear();
+        } else {
+            clause.push_back(lit);
         }
     }
-    inFile.close();
+    return clauses;
 }
 
 void DIMACSParser::printClauses() const {
-    cout << "Parsed Clauses (" << clauses.size() << " clauses):" << endl;
-    for (const auto& clause : clauses) {
-        for (int literal : clause) {
+    cout << "Parsed Clauses (" << parsedClauses << " clauses):\n";
+    for (int literal : literals) {
+        if (literal == 0) {
+            cout << "0\n";
+        } else {
             cout << literal << " ";
         }
-        cout << "0" << endl;
     }
 }
\ No newline at end of file
@@ -4,22 +4,42 @@
 #include <string>
 #include <vector>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 using namespace std;
 
+class DecompressStream;
+
+// Reads a DIMACS CNF file into one flat literal buffer. The file is mapped
+// into memory and scanned token by token, so clauses may span lines or
+// share a line; a trailing clause without its 0 is closed at end of input.
+// gzip, xz and bzip2 files are recognised by their magic bytes and
+// decompressed in blocks while the blocks already produced are scanned.
+//
+// Large inputs are cut at clause boundaries into one chunk per thread; the
+// chunks are scanned in parallel and concatenated in file order, so the
+// result does not depend on the number of threads (0 = all cores).
 class DIMACSParser {
 public:
-    DIMACSParser(const string& filename);
+    DIMACSParser(const string& filename, unsigned threads = 0);
+    // Text (or compressed text) already in memory, e.g. a mapped file
+    DIMACSParser(const char* data, size_t size, unsigned threads = 0);
     int getNumLiterals() const { return numLiterals; }
     int getNumClauses() const { return numClauses; }
-    const vector<vector<int>>& getClauses() const { return clauses; }
+    vector<vector<int>> getClauses() const;
+    // All clauses back to back, each terminated by 0 (as in the file)
+    const vector<int>& getLiterals() const { return literals; }
+    vector<int> releaseLiterals() { return move(literals); }  // leaves the parser empty
+    size_t getNumParsedClauses() const { return parsedClauses; }
     void printClauses() const;
 
 private:
-    int numLiterals;
-    int numClauses;
-    vector<vector<int>> clauses; // Use vector<int> to preserve order
+    void read(const char* data, size_t size, unsigned threads);
+    void parse(const char* p, const char* end, unsigned threads);
+    void parseStream(DecompressStream& stream);
+
+    int numLiterals = 0;
+    int numClauses = 0;
+    vector<int> literals; // Flat buffer, preserves clause and literal order
+    size_t parsedClauses = 0;
 };
 
 #endif // DIMACSPARSER_H
\ No newline at end of file
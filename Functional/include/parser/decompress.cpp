@@ -0,0 +1,278 @@
+#include "./decompress.h"
+#include <stdexcept>
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include "../general/log.h"
+
+#ifdef SAT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SAT_HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef SAT_HAVE_BZIP2
+#include <bzlib.h>
+#endif
+
+Compression detectCompression(const char* data, size_t size) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (size >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b) return Compression::Gzip;
+    if (size >= 6 && memcmp(bytes, "\xfd" "7zXZ\0", 6) == 0) return Compression::Xz;
+    if (size >= 4 && memcmp(bytes, "BZh", 3) == 0 && bytes[3] >= '1' && bytes[3] <= '9') return Compression::Bzip2;
+    return Compression::None;
+}
+
+const char* compressionName(Compression compression) {
+    switch (compression) {
+        case Compression::Gzip: return "gzip";
+        case Compression::Xz: return "xz";
+        case Compression::Bzip2: return "bzip2";
+        default: return "none";
+    }
+}
+
+namespace {
+
+[[noreturn]] void decodeError(Compression compression, const string& what) {
+    throw runtime_error(string(compressionName(compression)) + " input: " + what);
+}
+
+#ifdef SAT_HAVE_ZLIB
+// gzip, including files of several concatenated members
+class GzipDecoder : public Decoder {
+public:
+    GzipDecoder(const char* data, size_t size) : next(data), left(size) {
+        memset(&stream, 0, sizeof(stream));
+        // 32 + 15: gzip or zlib header, largest window
+        if (inflateInit2(&stream, 32 + 15) != Z_OK) decodeError(Compression::Gzip, "cannot initialise zlib");
+    }
+    ~GzipDecoder() override { inflateEnd(&stream); }
+
+    size_t read(char* out, size_t capacity) override {
+        stream.next_out = reinterpret_cast<Bytef*>(out);
+        stream.avail_out = static_cast<uInt>(min<size_t>(capacity, UINT_MAX));
+        while (stream.avail_out > 0 && !done) {
+            // avail_in is 32 bits wide, so large inputs are fed in pieces
+            if (stream.avail_in == 0) {
+                if (left == 0) decodeError(Compression::Gzip, "unexpected end of data");
+                stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(next));
+                stream.avail_in = static_cast<uInt>(min<size_t>(left, UINT_MAX));
+                next += stream.avail_in;
+                left -= stream.avail_in;
+            }
+            int result = inflate(&stream, Z_NO_FLUSH);
+            if (result == Z_STREAM_END) {
+                if (stream.avail_in == 0 && left == 0) {
+                    done = true;
+                } else if (inflateReset(&stream) != Z_OK) {
+                    decodeError(Compression::Gzip, "cannot start next member");
+                }
+            } else if (result != Z_OK && result != Z_BUF_ERROR) {
+                decodeError(Compression::Gzip, stream.msg ? stream.msg : "corrupt data");
+            }
+        }
+        return reinterpret_cast<char*>(stream.next_out) - out;
+    }
+
+private:
+    z_stream stream;
+    const char* next;  // input not yet handed to zlib
+    size_t left;
+    bool done = false;
+};
+#endif
+
+#ifdef SAT_HAVE_LZMA
+// xz, including concatenated streams
+class XzDecoder : public Decoder {
+public:
+    XzDecoder(const char* data, size_t size) {
+        if (lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+            decodeError(Compression::Xz, "cannot initialise liblzma");
+        }
+        stream.next_in = reinterpret_cast<const uint8_t*>(data);
+        stream.avail_in = size;
+    }
+    ~XzDecoder() override { lzma_end(&stream); }
+
+    size_t read(char* out, size_t capacity) override {
+        stream.next_out = reinterpret_cast<uint8_t*>(out);
+        stream.avail_out = capacity;
+        while (stream.avail_out > 0 && !done) {
+            // The whole input is available, so the decoder may finish
+            lzma_ret result = lzma_code(&stream, LZMA_FINISH);
+            if (result == LZMA_STREAM_END) {
+                done = true;
+            } else if (result == LZMA_BUF_ERROR) {
+                decodeError(Compression::Xz, "unexpected end of data");
+            } else if (result != LZMA_OK) {
+                decodeError(Compression::Xz, "corrupt data (liblzma error " + to_string(result) + ")");
+            }
+        }
+        return reinterpret_cast<char*>(stream.next_out) - out;
+    }
+
+private:
+    lzma_stream stream = LZMA_STREAM_INIT;
+    bool done = false;
+};
+#endif
+
+#ifdef SAT_HAVE_BZIP2
+// bzip2, including the multi-stream files written by parallel compressors
+class Bzip2Decoder : public Decoder {
+public:
+    Bzip2Decoder(const char* data, size_t size) : next(data), left(size) {
+        memset(&stream, 0, sizeof(stream));
+        if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK) decodeError(Compression::Bzip2, "cannot initialise libbz2");
+    }
+    ~Bzip2Decoder() override { BZ2_bzDecompressEnd(&stream); }
+
+    size_t read(char* out, size_t capacity) override {
+        stream.next_out = out;
+        stream.avail_out = static_cast<unsigned>(min<size_t>(capacity, UINT_MAX));
+        while (stream.avail_out > 0 && !done) {
+            if (stream.avail_in == 0 && left > 0) {
+                stream.next_in = const_cast<char*>(next);
+                stream.avail_in = static_cast<unsigned>(min<size_t>(left, UINT_MAX));
+                next += stream.avail_in;
+                left -= stream.avail_in;
+            }
+            bool starved = stream.avail_in == 0;
+            unsigned before = stream.avail_out;
+            int result = BZ2_bzDecompress(&stream);
+            if (result == BZ_STREAM_END) {
+                if (stream.avail_in == 0 && left == 0) {
+                    done = true;
+                } else {
+                    // Another stream follows; keep the unread input and
+                    // the output position
+                    bz_stream rest = stream;
+                    BZ2_bzDecompressEnd(&stream);
+                    memset(&stream, 0, sizeof(stream));
+                    if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK) {
+                        decodeError(Compression::Bzip2, "cannot start next stream");
+                    }
+                    stream.next_in = rest.next_in;
+                    stream.avail_in = rest.avail_in;
+                    stream.next_out = rest.next_out;
+                    stream.avail_out = rest.avail_out;
+                }
+            } else if (result != BZ_OK) {
+                decodeError(Compression::Bzip2, "corrupt data (libbz2 error " + to_string(result) + ")");
+            } else if (starved && stream.avail_out == before) {
+                decodeError(Compression::Bzip2, "unexpected end of data");
+            }
+        }
+        return stream.next_out - out;
+    }
+
+private:
+    bz_stream stream;
+    const char* next;
+    size_t left;
+    bool done = false;
+};
+#endif
+
+} // namespace
+
+unique_ptr<Decoder> Decoder::create(Compression compression, const char* data, size_t size) {
+    switch (compression) {
+#ifdef SAT_HAVE_ZLIB
+        case Compression::Gzip: return make_unique<GzipDecoder>(data, size);
+#endif
+#ifdef SAT_HAVE_LZMA
+        case Compression::Xz: return make_unique<XzDecoder>(data, size);
+#endif
+#ifdef SAT_HAVE_BZIP2
+        case Compression::Bzip2: return make_unique<Bzip2Decoder>(data, size);
+#endif
+        case Compression::None:
+            throw invalid_argument("Decoder::create: input is not compressed");
+        default:
+            static_cast<void>(data);
+            static_cast<void>(size);
+            decodeError(compression, "support was not compiled in");
+    }
+}
+
+DecompressStream::DecompressStream(Compression compression, const char* data, size_t size)
+    : decoder(Decoder::create(compression, data, size)) {
+    LOG_DEBUG("Decompressing " << compressionName(compression) << " input of " << size << " bytes");
+    producer = thread(&DecompressStream::produce, this);
+}
+
+DecompressStream::~DecompressStream() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopped = true;
+    }
+    drained.notify_all();
+    producer.join();
+}
+
+bool DecompressStream::next(vector<char>& block) {
+    unique_lock<mutex> guard(lock);
+    ready.wait(guard, [this]() { return !queue.empty() || finished; });
+    if (queue.empty()) {
+        if (error) rethrow_exception(error);
+        return false;
+    }
+    block.swap(queue.front());
+    queue.pop_front();
+    guard.unlock();
+    drained.notify_one();
+    return true;
+}
+
+// Queues a block, waiting while the queue is full; false once the consumer
+// has gone away
+bool DecompressStream::push(vector<char>& block) {
+    unique_lock<mutex> guard(lock);
+    drained.wait(guard, [this]() { return queue.size() < QUEUE_BLOCKS || stopped; });
+    if (stopped) return false;
+    queue.push_back(move(block));
+    guard.unlock();
+    ready.notify_one();
+    return true;
+}
+
+void DecompressStream::produce() {
+    try {
+        // The bytes after the last line break of a block move to the next one
+        vector<char> carry;
+        while (true) {
+            vector<char> block;
+            block.swap(carry);
+            size_t kept = block.size();
+            block.resize(kept + BLOCK_BYTES);
+            size_t count = decoder->read(block.data() + kept, BLOCK_BYTES);
+            block.resize(kept + count);
+
+            if (count == 0) {
+                if (!block.empty()) push(block);
+                break;
+            }
+            auto lineEnd = find(block.rbegin(), block.rend(), '\n');
+            if (lineEnd == block.rend()) {
+                // No complete line yet: keep reading into the same block
+                carry.swap(block);
+                continue;
+            }
+            size_t cut = block.rend() - lineEnd;
+            carry.assign(block.begin() + cut, block.end());
+            block.resize(cut);
+            if (!push(block)) return;
+        }
+    } catch (...) {
+        lock_guard<mutex> guard(lock);
+        error = current_exception();
+    }
+    {
+        lock_guard<mutex> guard(lock);
+        finished = true;
+    }
+    ready.notify_all();
+}
@@ -0,0 +1,69 @@
+#ifndef DECOMPRESS_H
+#define DECOMPRESS_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstddef>
+
+#pragma once
+
+using namespace std;
+
+enum class Compression { None, Gzip, Xz, Bzip2 };
+
+// Format of data from its leading magic bytes; None for plain text
+Compression detectCompression(const char* data, size_t size);
+const char* compressionName(Compression compression);
+
+// Decoder of one compressed format. Throws runtime_error on corrupt or
+// truncated input, or when support for the format was not compiled in.
+class Decoder {
+public:
+    static unique_ptr<Decoder> create(Compression compression, const char* data, size_t size);
+    virtual ~Decoder() = default;
+
+    // Fills out with up to capacity decompressed bytes; 0 at end of data
+    virtual size_t read(char* out, size_t capacity) = 0;
+};
+
+// Decompresses on a background thread and hands out the result in blocks
+// that end on a line break, so a block never cuts a token or a comment.
+// At most QUEUE_BLOCKS blocks wait in memory; the rest of the decompressed
+// data is produced as the consumer catches up.
+class DecompressStream {
+public:
+    DecompressStream(Compression compression, const char* data, size_t size);
+    ~DecompressStream();
+
+    DecompressStream(const DecompressStream&) = delete;
+    DecompressStream& operator=(const DecompressStream&) = delete;
+
+    // Next block in stream order; false at end. Rethrows a decoder error
+    // once every block before it has been handed out.
+    bool next(vector<char>& block);
+
+private:
+    void produce();
+    bool push(vector<char>& block);
+
+    static const size_t BLOCK_BYTES = 1 << 20;
+    static const size_t QUEUE_BLOCKS = 4;
+
+    unique_ptr<Decoder> decoder;
+    deque<vector<char>> queue;
+    mutex lock;
+    condition_variable ready;    // a block was queued or the stream ended
+    condition_variable drained;  // a block was taken or the consumer left
+    bool finished = false;
+    bool stopped = false;
+    exception_ptr error;
+    thread producer;
+};
+
+#endif // DECOMPRESS_H
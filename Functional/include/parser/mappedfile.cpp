@@ -0,0 +1,86 @@
+#include "./mappedfile.h"
+#include <cstdio>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const string& filename) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw runtime_error("Failed to open file: " + filename);
+    }
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        HANDLE map = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (map != nullptr) {
+            void* view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+            if (view != nullptr) {
+                fileHandle = file;
+                mappingHandle = map;
+                mapping = view;
+                begin = static_cast<const char*>(view);
+                length = static_cast<size_t>(fileSize.QuadPart);
+                return;
+            }
+            CloseHandle(map);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Failed to open file: " + filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            // The file is read front to back exactly once
+            madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            close(fd);
+            mapping = view;
+            begin = static_cast<const char*>(view);
+            length = static_cast<size_t>(st.st_size);
+            return;
+        }
+    }
+    close(fd);
+#endif
+    readWhole(filename);
+}
+
+MappedFile::~MappedFile() {
+    if (mapping == nullptr) return;
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+#else
+    munmap(mapping, length);
+#endif
+}
+
+// Fallback for empty files and streams that cannot be mapped
+void MappedFile::readWhole(const string& filename) {
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        throw runtime_error("Failed to open file: " + filename);
+    }
+    char chunk[1 << 16];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        buffer.insert(buffer.end(), chunk, chunk + n);
+    }
+    fclose(file);
+    begin = buffer.data();
+    length = buffer.size();
+}
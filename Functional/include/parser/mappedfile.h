@@ -0,0 +1,41 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#pragma once
+
+using namespace std;
+
+// Read-only view of a whole file. Regular files are memory-mapped (mmap on
+// POSIX, a file mapping on Windows); anything that cannot be mapped, such
+// as a pipe, is read into memory instead. Throws runtime_error if the file
+// cannot be opened.
+class MappedFile {
+public:
+    explicit MappedFile(const string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return begin; }
+    size_t size() const { return length; }
+    bool mapped() const { return mapping != nullptr; }
+
+private:
+    void readWhole(const string& filename);
+
+    const char* begin = nullptr;
+    size_t length = 0;
+    void* mapping = nullptr;  // start of the mapped view, null when read
+    vector<char> buffer;      // file contents when not mapped
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
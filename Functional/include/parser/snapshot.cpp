@@ -0,0 +1,64 @@
+#include "./snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+uint64_t hashLiterals(span<const int> literals) {
+    return summarizeLiterals(literals).hash;
+}
+
+LiteralSummary summarizeLiterals(span<const int> literals) {
+    LiteralSummary summary{0xcbf29ce484222325ull, 0, 0};
+    for (int literal : literals) {
+        summary.hash ^= static_cast<uint32_t>(literal);
+        summary.hash *= 0x100000001b3ull;
+        // Widened first, so INT_MIN cannot overflow
+        int64_t var = literal < 0 ? -static_cast<int64_t>(literal) : literal;
+        if (var == 0) summary.clauses++;
+        summary.maxVar = max(summary.maxVar, var);
+    }
+    return summary;
+}
+
+bool isSnapshot(const char* data, size_t size) {
+    return size >= sizeof(SNAPSHOT_MAGIC) && memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+}
+
+const SnapshotHeader& readSnapshotHeader(const char* data, size_t size) {
+    if (!isSnapshot(data, size) || size < sizeof(SnapshotHeader)) {
+        throw runtime_error("Not a formula snapshot");
+    }
+    const SnapshotHeader& header = *reinterpret_cast<const SnapshotHeader*>(data);
+    if (header.byteOrder != SNAPSHOT_BYTE_ORDER) {
+        throw runtime_error("Snapshot was written on a machine of another byte order");
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        throw runtime_error("Snapshot version " + to_string(header.version) + " is not supported (expected " +
+                            to_string(SNAPSHOT_VERSION) + ")");
+    }
+    if ((size - sizeof(SnapshotHeader)) / sizeof(int) != header.literalCount ||
+        (size - sizeof(SnapshotHeader)) % sizeof(int) != 0) {
+        throw runtime_error("Snapshot is truncated or has trailing data");
+    }
+    return header;
+}
+
+void writeSnapshot(const string& filename, const SnapshotHeader& header, span<const int> literals) {
+    string temporary = filename + ".tmp";
+    FILE* file = fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+        throw runtime_error("Failed to create snapshot file: " + temporary);
+    }
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(literals.data(), sizeof(int), literals.size(), file) == literals.size();
+    written = (fclose(file) == 0) && written;
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    if (written) remove(filename.c_str());
+#endif
+    if (!written || rename(temporary.c_str(), filename.c_str()) != 0) {
+        remove(temporary.c_str());
+        throw runtime_error("Failed to write snapshot file: " + filename);
+    }
+}
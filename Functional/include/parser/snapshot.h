@@ -0,0 +1,65 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+#pragma once
+
+using namespace std;
+
+// Binary snapshot of a parsed formula, written once and then mapped
+// straight into memory instead of parsing the text again. Layout, in the
+// byte order of the machine that wrote it:
+//
+//   SnapshotHeader (64 bytes)
+//   literalCount int32 words: the clauses back to back, each ended by 0
+//
+// The version is bumped on any layout change; readers reject snapshots of
+// another version or byte order rather than converting them.
+struct SnapshotHeader {
+    char magic[8];           // SNAPSHOT_MAGIC
+    uint32_t version;        // SNAPSHOT_VERSION
+    uint32_t byteOrder;      // SNAPSHOT_BYTE_ORDER as written by the producer
+    int32_t numLiterals;     // problem line: variables
+    int32_t numClauses;      // problem line: clauses
+    int32_t numVars;         // highest variable index, at least numLiterals
+    uint32_t reserved;
+    uint64_t parsedClauses;  // clauses in the literal buffer
+    uint64_t literalCount;   // words in the literal buffer, terminators included
+    uint64_t hash;           // hashLiterals() of the literal buffer
+    uint64_t reserved2;
+};
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header layout changed");
+
+const char SNAPSHOT_MAGIC[8] = {'S', 'A', 'T', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+// 64-bit FNV-1a over the literal words
+uint64_t hashLiterals(span<const int> literals);
+
+// What a reader checks the header against, taken in one pass over the
+// literal words: their hashLiterals(), the highest variable and the clause
+// count (the 0 terminators)
+struct LiteralSummary {
+    uint64_t hash;
+    int64_t maxVar;
+    uint64_t clauses;
+};
+LiteralSummary summarizeLiterals(span<const int> literals);
+
+bool isSnapshot(const char* data, size_t size);
+
+// Checks the header of a snapshot in memory against its size and returns
+// it; throws runtime_error for another version or byte order, or a
+// truncated file. The literals follow the header.
+const SnapshotHeader& readSnapshotHeader(const char* data, size_t size);
+
+// Writes to a temporary file next to filename and renames it, so readers
+// never see a partial snapshot. Throws runtime_error on I/O failure.
+void writeSnapshot(const string& filename, const SnapshotHeader& header, span<const int> literals);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,135 @@
+#include "./portfolioentry.h"
+#include "../cdcl/cdclsolver.h"
+#include "../dp/dpsolver.h"
+#include "../res/resolutionsolver.h"
+#include "../general/log.h"
+
+namespace {
+
+// DP and resolution take a place only below these sizes
+const int SMALL_VARS = 100;
+const size_t SMALL_CLAUSES = 500;
+
+PortfolioEntry makeEntry(const string& solver, RestartStrategy restart, uint64_t interval, PhaseMode phase,
+                         BranchHeuristic heuristic = BranchHeuristic::VSIDS) {
+    PortfolioEntry entry;
+    entry.solver = solver;
+    entry.restart = restart;
+    entry.restartInterval = interval;
+    entry.phase = phase;
+    entry.heuristic = heuristic;
+    return entry;
+}
+
+const char* restartName(RestartStrategy restart) {
+    switch (restart) {
+        case RestartStrategy::None: return "no restarts";
+        case RestartStrategy::Fixed: return "fixed restarts";
+        case RestartStrategy::Luby: return "luby restarts";
+        default: return "glucose restarts";
+    }
+}
+
+const char* phaseName(PhaseMode phase) {
+    switch (phase) {
+        case PhaseMode::Heuristic: return "heuristic phase";
+        case PhaseMode::Target: return "target phase";
+        case PhaseMode::Best: return "best phase";
+        default: return "saved phase";
+    }
+}
+
+const char* heuristicName(BranchHeuristic heuristic) {
+    switch (heuristic) {
+        case BranchHeuristic::MaxFrequency: return "max frequency";
+        case BranchHeuristic::MOMs: return "MOMs";
+        case BranchHeuristic::JeroslowWang: return "Jeroslow-Wang";
+        default: return "VSIDS";
+    }
+}
+
+template <typename Solver>
+void configure(Solver& solver, const PortfolioEntry& entry, function<bool()> stop) {
+    solver.setRestartStrategy(entry.restart, entry.restartInterval);
+    solver.setPhaseMode(entry.phase);
+    solver.setSeed(entry.seed);
+    solver.setTerminate(move(stop));
+}
+
+} // namespace
+
+string PortfolioEntry::describe() const {
+    string text = solver;
+    if (solver == "dpll") text += string(" ") + heuristicName(heuristic);
+    if (solver == "cdcl" || solver == "dpll") {
+        text += string(", ") + restartName(restart) + ", " + phaseName(phase);
+        if (seed != 0) text += ", seed " + to_string(seed);
+    }
+    return text;
+}
+
+PortfolioEntry portfolioEntry(int index, const Formula& formula) {
+    bool small = formula.getNumVars() <= SMALL_VARS && formula.getNumParsedClauses() <= SMALL_CLAUSES;
+    const PortfolioEntry entries[] = {
+        makeEntry("cdcl", RestartStrategy::Glucose, 100, PhaseMode::Saved),
+        makeEntry("cdcl", RestartStrategy::Luby, 100, PhaseMode::Saved),
+        makeEntry("dpll", RestartStrategy::Luby, 100, PhaseMode::Saved, BranchHeuristic::VSIDS),
+        makeEntry("cdcl", RestartStrategy::Glucose, 100, PhaseMode::Target),
+        makeEntry("dpll", RestartStrategy::None, 100, PhaseMode::Heuristic, BranchHeuristic::JeroslowWang),
+        makeEntry("cdcl", RestartStrategy::Luby, 512, PhaseMode::Best),
+        small ? makeEntry("dp", RestartStrategy::None, 100, PhaseMode::Heuristic)
+              : makeEntry("cdcl", RestartStrategy::Fixed, 300, PhaseMode::Saved),
+        small ? makeEntry("res", RestartStrategy::None, 100, PhaseMode::Heuristic)
+              : makeEntry("cdcl", RestartStrategy::Luby, 100, PhaseMode::Target),
+        makeEntry("dpll", RestartStrategy::None, 100, PhaseMode::Heuristic, BranchHeuristic::MOMs),
+    };
+    const int count = sizeof(entries) / sizeof(entries[0]);
+    const int cdclEntries[] = {0, 1, 3, 5};
+
+    PortfolioEntry entry = index < count ? entries[index] : entries[cdclEntries[index % 4]];
+    // Repeated configurations differ by seed; entry 0 stays deterministic
+    if (index > 0) entry.seed = static_cast<uint64_t>(index);
+    return entry;
+}
+
+SolveResult solveEntry(const PortfolioEntry& entry, shared_ptr<const Formula> formula, function<bool()> stop,
+                       ClauseSharing* sharing, vector<int>& model) {
+    bool sat = false;
+    bool interrupted = false;
+    if (entry.solver == "cdcl") {
+        CDCLSolver solver(formula);
+        configure(solver, entry, move(stop));
+        solver.setClauseSharing(sharing);
+        SolveResult result = solver.solve(vector<int>());
+        if (result == SolveResult::Sat) model = solver.getAssignment();
+        return result;
+    } else if (entry.solver == "dpll") {
+        DPLLSolver solver(formula);
+        solver.setHeuristic(entry.heuristic);
+        configure(solver, entry, move(stop));
+        sat = solver.solve();
+        interrupted = solver.wasInterrupted();
+        if (sat) model = solver.getAssignment();
+    } else if (entry.solver == "dp") {
+        DPSolver solver(formula);
+        solver.setTerminate(move(stop));
+        sat = solver.solve();
+        interrupted = solver.wasInterrupted();
+        if (sat) model = solver.getAssignment();
+        // Eliminated variables are not given values back, so the
+        // assignment is not always a model; without one the answer
+        // cannot be checked
+        if (sat && !formula->isModel(model)) {
+            LOG_DEBUG("DP found the formula satisfiable without a complete model");
+            return SolveResult::Unknown;
+        }
+    } else {
+        // Resolution never builds a model: it can only win with UNSAT
+        ResolutionSolver solver(formula);
+        solver.setTerminate(move(stop));
+        sat = solver.solve();
+        if (solver.wasInterrupted() || sat) return SolveResult::Unknown;
+    }
+    if (interrupted) return SolveResult::Unknown;
+    return sat ? SolveResult::Sat : SolveResult::Unsat;
+}
@@ -0,0 +1,45 @@
+#ifndef PORTFOLIOENTRY_H
+#define PORTFOLIOENTRY_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include "../general/formula.h"
+#include "../general/satsolver.h"
+#include "../general/clausesharing.h"
+#include "../dpll/dpllsolver.h"
+
+#pragma once
+
+using namespace std;
+
+// One solver configuration of a portfolio
+struct PortfolioEntry {
+    string solver = "cdcl";  // cdcl, dpll, dp or res
+    BranchHeuristic heuristic = BranchHeuristic::VSIDS;  // dpll only
+    RestartStrategy restart = RestartStrategy::Glucose;
+    uint64_t restartInterval = 100;
+    PhaseMode phase = PhaseMode::Saved;
+    uint64_t seed = 0;
+
+    string describe() const;
+};
+
+// Configuration of portfolio member index (an MPI rank or a thread). The
+// first members get the most different configurations (CDCL with each
+// restart and phase policy, DPLL with its heuristics); DP and resolution
+// only join on small formulas, where they can finish. Further members
+// repeat the CDCL entries with other seeds.
+PortfolioEntry portfolioEntry(int index, const Formula& formula);
+
+// Runs the entry's solver on formula until it answers or stop() returns
+// true (Unknown). model is filled after Sat. Resolution, which has no
+// model to give, and DP when its assignment is incomplete answer Unknown
+// instead of Sat. Only CDCL takes part in clause sharing; sharing may be
+// nullptr.
+SolveResult solveEntry(const PortfolioEntry& entry, shared_ptr<const Formula> formula, function<bool()> stop,
+                       ClauseSharing* sharing, vector<int>& model);
+
+#endif // PORTFOLIOENTRY_H
@@ -0,0 +1,67 @@
+#include "./threadportfolio.h"
+#include "./portfolioentry.h"
+#include "../general/clausesharing.h"
+#include "../general/threadpool.h"
+#include "../general/log.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+
+namespace {
+
+// The caller's stop callback is asked only every this many calls; the
+// answered flag on every call
+const unsigned POLL_INTERVAL = 64;
+
+} // namespace
+
+ThreadPortfolioResult runThreadPortfolio(shared_ptr<const Formula> formula, unsigned threads,
+                                         function<bool()> stop, bool share) {
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    unique_ptr<ThreadClauseSharing> sharing;
+    if (share && threads > 1) sharing = make_unique<ThreadClauseSharing>(threads);
+
+    ThreadPortfolioResult result;
+    atomic<bool> answered{false};
+    mutex lock;  // guards result
+    {
+        ThreadPool pool(threads);
+        for (unsigned i = 0; i < threads; i++) {
+            pool.submit([&, i]() {
+                PortfolioEntry entry = portfolioEntry(static_cast<int>(i), *formula);
+                LOG_DEBUG("Thread " << i << ": " << entry.describe());
+                unsigned polls = 0;
+                auto stopped = [&]() {
+                    if (answered.load(memory_order_relaxed)) return true;
+                    return ++polls % POLL_INTERVAL == 0 && stop && stop();
+                };
+
+                vector<int> model;
+                SolveResult outcome =
+                    solveEntry(entry, formula, stopped, sharing ? &sharing->endpoint(i) : nullptr, model);
+                if (outcome == SolveResult::Sat && !formula->isModel(model)) {
+                    LOG_ERROR("Thread " << i << " (" << entry.describe() << ") reported SAT without a valid model");
+                    outcome = SolveResult::Unknown;
+                }
+                if (outcome == SolveResult::Unknown) return;
+
+                lock_guard<mutex> guard(lock);
+                if (result.winner >= 0) return;
+                result.winner = static_cast<int>(i);
+                result.status = outcome;
+                result.model = move(model);
+                answered.store(true, memory_order_relaxed);
+            });
+        }
+        pool.wait();
+    }
+
+    if (sharing) {
+        for (unsigned i = 0; i < threads; i++) {
+            result.exported += sharing->endpoint(i).getExported();
+            result.imported += sharing->endpoint(i).getImported();
+        }
+    }
+    return result;
+}
@@ -0,0 +1,37 @@
+#ifndef THREADPORTFOLIO_H
+#define THREADPORTFOLIO_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include "../general/formula.h"
+#include "../general/satsolver.h"
+
+#pragma once
+
+using namespace std;
+
+struct ThreadPortfolioResult {
+    SolveResult status = SolveResult::Unknown;
+    int winner = -1;        // index of the solver that answered, -1 if none did
+    vector<int> model;      // after Sat
+    uint64_t exported = 0;  // clauses shared, summed over the solvers
+    uint64_t imported = 0;
+};
+
+// Shared-memory portfolio: solvers portfolioEntry(0) to
+// portfolioEntry(threads - 1) (see portfolio/portfolioentry.h) run on the
+// same formula side by side, one per thread (0 for all cores). The formula
+// is parsed once and shared; every solver has its own trail, watches and
+// learnt clauses. The first definitive answer raises an atomic flag that
+// stops all the others; a SAT answer only counts if its assignment
+// satisfies every clause. stop (may be empty) is polled as well, from all
+// threads at once. With share, the CDCL solvers exchange learnt clauses
+// through a ThreadClauseSharing.
+//
+// The solvers' progress output on cout is left to the caller to silence.
+ThreadPortfolioResult runThreadPortfolio(shared_ptr<const Formula> formula, unsigned threads,
+                                         function<bool()> stop = nullptr, bool share = true);
+
+#endif // THREADPORTFOLIO_H
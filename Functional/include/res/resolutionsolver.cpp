@@ -1,5 +1,6 @@
 #include "./resolutionsolver.h"
 #include "../general/satsolver.h"
+#include "../general/log.h"
 #include <iostream>
 #include <set>
 #include <vector>
@@ -9,25 +10,29 @@
 using namespace std;
 
     ResolutionSolver::ResolutionSolver(const string& filename) : SATSolver(filename) {}
+
+    ResolutionSolver::ResolutionSolver(shared_ptr<const Formula> formula) : SATSolver(move(formula)) {}
+
     bool ResolutionSolver::solve() {
-        cout << "[DEBUG] Solving using Resolution..." << endl;
+        LOG_DEBUG("Solving using Resolution...");
+        interrupted = false;
 
         // Convert clauses to sets for easier resolution, skipping tautological clauses
         vector<set<int>> clauseSets;
         set<set<int>> uniqueClauses; // To track unique clauses
-        for (const auto& clause : clauses) {
+        for (CRef cr : clauses) {
+            const Clause clause = ca[cr];
             set<int> clauseSet(clause.begin(), clause.end());
             if (isTautology(clauseSet)) {
-                cout << "[DEBUG] Tautological clause removed: ";
-                printClause(clauseSet);
+                LOG_TRACE("Tautological clause removed: { " << satlog::join(clauseSet) << "}");
                 continue; // Skip tautological clauses
             }
             clauseSets.push_back(clauseSet);
             uniqueClauses.insert(clauseSet); // Add to unique clause tracker
         }
 
-        cout << "[DEBUG] Initial clause sets after tautology elimination:" << endl;
-        printClauseSets(clauseSets);
+        LOG_DEBUG("Initial clause sets after tautology elimination: " << clauseSets.size());
+        if (LOG_ENABLED(TRACE)) printClauseSets(clauseSets);
 
         const size_t MAX_CLAUSES = 10000; // Limit the number of clauses to prevent infinite loops
         size_t iterationCount = 0;       // Track the number of iterations
@@ -42,15 +47,16 @@ using namespace std;
 
             // Generate all resolvents
             for (size_t i = 0; i < clauseSets.size(); i++) {
+                if (stopRequested()) return false;
                 for (size_t j = i + 1; j < clauseSets.size(); j++) {
                     set<int> resolvent;
                     if (resolve(clauseSets[i], clauseSets[j], resolvent)) {
-                        cout << "[DEBUG] Resolvent generated from clauses " << i << " and " << j << ": ";
-                        printClause(resolvent);
+                        LOG_TRACE("Resolvent generated from clauses " << i << " and " << j << ": { "
+                                  << satlog::join(resolvent) << "}");
 
                         // If the resolvent is empty, UNSAT is detected
                         if (resolvent.empty()) {
-                            cout << "[DEBUG] Empty resolvent found. UNSATISFIABLE." << endl;
+                            LOG_DEBUG("Empty resolvent found. UNSATISFIABLE.");
                             return false;
                         }
 
@@ -65,32 +71,34 @@ using namespace std;
 
             // Check if new clauses are already in the set of clauses
             if (newClauses.empty()) {
-                cout << "[DEBUG] No new clauses added. SATISFIABLE." << endl;
+                LOG_DEBUG("No new clauses added. SATISFIABLE.");
                 return true;
             }
 
             // Add new clauses to the clause set
             for (const auto& clause : newClauses) {
                 clauseSets.push_back(clause);
-                cout << "[DEBUG] New clause added: ";
-                printClause(clause);
+                LOG_TRACE("New clause added: { " << satlog::join(clause) << "}");
             }
 
             // Break condition: Stop if the number of clauses exceeds the limit
             if (clauseSets.size() > MAX_CLAUSES) {
-                cout << "[DEBUG] Clause limit exceeded (" << MAX_CLAUSES << "). Terminating resolution." << endl;
+                // Giving up is not a proof of UNSAT
+                LOG_INFO("Clause limit exceeded (" << MAX_CLAUSES << "). Terminating resolution.");
+                interrupted = true;
                 return false;
             }
 
             // Optional: Add a limit on the number of iterations
             iterationCount++;
             if (iterationCount > 1000) { // Arbitrary iteration limit
-                cout << "[DEBUG] Iteration limit exceeded. Terminating resolution." << endl;
+                LOG_INFO("Iteration limit exceeded. Terminating resolution.");
+                interrupted = true;
                 return false;
             }
 
-            cout << "[DEBUG] Updated clause sets after iteration " << iterationCount << ":" << endl;
-            printClauseSets(clauseSets);
+            LOG_DEBUG("Updated clause sets after iteration " << iterationCount << ": " << clauseSets.size());
+            if (LOG_ENABLED(TRACE)) printClauseSets(clauseSets);
         }
     }
 
@@ -106,8 +114,7 @@ using namespace std;
 
                 // Check if the resolvent is a tautology
                 if (isTautology(resolvent)) {
-                    cout << "[DEBUG] Tautological resolvent discarded: ";
-                    printClause(resolvent);
+                    LOG_TRACE("Tautological resolvent discarded: { " << satlog::join(resolvent) << "}");
                     return false; // Skip tautological resolvents
                 }
 
@@ -134,7 +141,7 @@ using namespace std;
         for (int literal : clause) {
             cout << literal << " ";
         }
-        cout << "}" << endl;
+        cout << "}\n";
     }
 
     // Helper function to print all clause sets
@@ -19,6 +19,7 @@ public:
     bool resolve(const set<int>& clause1, const set<int>& clause2, set<int>& resolvent);
 
     ResolutionSolver(const string& filename);
+    explicit ResolutionSolver(shared_ptr<const Formula> formula);
     bool solve();
 };
 
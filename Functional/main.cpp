@@ -6,6 +6,12 @@
 #include "include/dpll/dpllsolver.h"
 #include "include/dp/dpsolver.h"
 #include "include/res/resolutionsolver.h"
+#include "include/cdcl/cdclsolver.h"
+#include "include/portfolio/portfolioentry.h"
+#include "include/portfolio/threadportfolio.h"
+#include "include/dpll/paralleldpll.h"
+#include "include/general/log.h"
+#include "include/cli/cli.h"
 
 using namespace std;
 
@@ -20,8 +26,12 @@ void printMenu() {
     cout << "1. DPLL algorithm\n";
     cout << "2. Davis-Putnam algorithm\n";
     cout << "3. Resolution-based solver\n";
+    cout << "4. CDCL (conflict-driven clause learning)\n";
+    cout << "5. Save a binary snapshot of a CNF file\n";
+    cout << "6. Portfolio of solvers on all cores\n";
+    cout << "7. DPLL split across all cores (work stealing)\n";
     cout << "0. Exit\n";
-    cout << "Choose a solver (0-3): ";
+    cout << "Choose a solver (0-7): ";
 }
 
 string getSolverType(int choice) {
@@ -29,11 +39,17 @@ string getSolverType(int choice) {
         case 1: return "dpll";
         case 2: return "dp";
         case 3: return "res";
+        case 4: return "cdcl";
+        case 6: return "portfolio";
+        case 7: return "pdpll";
         default: return "";
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // With arguments the program runs non-interactively (see cli.h)
+    if (argc > 1) return runCommandLine(argc, argv);
+
     while (true) {
         printMenu();
 
@@ -45,7 +61,7 @@ int main() {
             break;
         }
 
-        if (choice < 1 || choice > 3) {
+        if (choice < 1 || choice > 7) {
             cout << "Invalid choice. Please try again.\n";
             continue;
         }
@@ -62,19 +78,36 @@ int main() {
             continue;
         }
 
+        // Snapshots load without parsing; every solver accepts them as input
+        if (choice == 5) {
+            cout << "Enter the path of the snapshot to write: ";
+            string snapshotFile;
+            cin >> snapshotFile;
+            try {
+                auto start = chrono::high_resolution_clock::now();
+                auto formula = Formula::load(filename);
+                formula->saveSnapshot(snapshotFile);
+                auto end = chrono::high_resolution_clock::now();
+                auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+                cout << "Snapshot written: " << formula->getNumVars() << " variables, "
+                     << formula->getNumParsedClauses() << " clauses (" << duration.count() << "ms)" << endl;
+            } catch (const exception& e) {
+                cout << "Error: " << e.what() << endl;
+            }
+            continue;
+        }
 
         cout << "\nSolving with " << solver_type << " solver...\n";
         try {
             if (solver_type == "dpll") {
-                DPLLSolver solver(filename);
-                DIMACSParser parser(filename);
-                auto originalClauses = parser.getClauses();
+                auto formula = Formula::load(filename);
+                DPLLSolver solver(formula);
 
                 auto start = chrono::high_resolution_clock::now();
                 cout << "Parser initialized successfully" << endl;
                 cout << "Formula statistics:" << endl;
-                cout << "Variables: " << parser.getNumLiterals() << endl;
-                cout << "Clauses: " << parser.getNumClauses() << endl;
+                cout << "Variables: " << formula->getNumLiterals() << endl;
+                cout << "Clauses: " << formula->getNumClauses() << endl;
 
                 bool result = solver.solve();
                 auto assignment = solver.getAssignment();
@@ -82,7 +115,10 @@ int main() {
                 auto end = chrono::high_resolution_clock::now();
                 auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
 
-                if (result) {
+                satlog::flush();
+                if (solver.wasInterrupted()) {
+                    cout << "Final result: Unknown, the solver stopped without an answer." << endl;
+                } else if (result) {
                     cout << "Final result: The formula is SATISFIABLE." << endl;
                 } else {
                     cout << "Final result: The formula is UNSATISFIABLE." << endl;
@@ -91,15 +127,14 @@ int main() {
                 cout << "Solving time: " << duration.count() << "ms" << endl;
 
             } else if (solver_type == "dp") {
-                DPSolver solver(filename);
-                DIMACSParser parser(filename);
-                auto originalClauses = parser.getClauses();
+                auto formula = Formula::load(filename);
+                DPSolver solver(formula);
 
                 auto start = chrono::high_resolution_clock::now();
                 cout << "Parser initialized successfully" << endl;
                 cout << "Formula statistics:" << endl;
-                cout << "Variables: " << parser.getNumLiterals() << endl;
-                cout << "Clauses: " << parser.getNumClauses() << endl;
+                cout << "Variables: " << formula->getNumLiterals() << endl;
+                cout << "Clauses: " << formula->getNumClauses() << endl;
 
                 bool result = solver.solve();
                 auto assignment = solver.getAssignment();
@@ -107,7 +142,10 @@ int main() {
                 auto end = chrono::high_resolution_clock::now();
                 auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
 
-                if (result) {
+                satlog::flush();
+                if (solver.wasInterrupted()) {
+                    cout << "Final result: Unknown, the solver stopped without an answer." << endl;
+                } else if (result) {
                     cout << "Final result: The formula is SATISFIABLE." << endl;
                 } else {
                     cout << "Final result: The formula is UNSATISFIABLE." << endl;
@@ -115,27 +153,108 @@ int main() {
 
                 cout << "Solving time: " << duration.count() << "ms" << endl;
             } else if (solver_type == "res") {
-                ResolutionSolver solver(filename);
-                DIMACSParser parser(filename);
-                auto originalClauses = parser.getClauses();
+                auto formula = Formula::load(filename);
+                ResolutionSolver solver(formula);
 
                 auto start = chrono::high_resolution_clock::now();
                 cout << "Parser initialized successfully" << endl;
                 cout << "Formula statistics:" << endl;
-                cout << "Variables: " << parser.getNumLiterals() << endl;
-                cout << "Clauses: " << parser.getNumClauses() << endl;
+                cout << "Variables: " << formula->getNumLiterals() << endl;
+                cout << "Clauses: " << formula->getNumClauses() << endl;
 
                 bool result = solver.solve();
 
                 auto end = chrono::high_resolution_clock::now();
                 auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
 
-                if (result) {
+                satlog::flush();
+                if (solver.wasInterrupted()) {
+                    cout << "Final result: Unknown, the solver stopped without an answer." << endl;
+                } else if (result) {
                     cout << "Final result: The formula is SATISFIABLE." << endl;
                 } else {
                     cout << "Final result: The formula is UNSATISFIABLE." << endl;
                 }
 
+                cout << "Solving time: " << duration.count() << "ms" << endl;
+            } else if (solver_type == "cdcl") {
+                auto formula = Formula::load(filename);
+                CDCLSolver solver(formula);
+
+                auto start = chrono::high_resolution_clock::now();
+                cout << "Parser initialized successfully" << endl;
+                cout << "Formula statistics:" << endl;
+                cout << "Variables: " << formula->getNumLiterals() << endl;
+                cout << "Clauses: " << formula->getNumClauses() << endl;
+
+                bool result = solver.solve();
+                auto assignment = solver.getAssignment();
+
+                auto end = chrono::high_resolution_clock::now();
+                auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+
+                satlog::flush();
+                if (solver.wasInterrupted()) {
+                    cout << "Final result: Unknown, the solver stopped without an answer." << endl;
+                } else if (result) {
+                    cout << "Final result: The formula is SATISFIABLE." << endl;
+                } else {
+                    cout << "Final result: The formula is UNSATISFIABLE." << endl;
+                }
+
+                cout << "Solving time: " << duration.count() << "ms" << endl;
+            } else if (solver_type == "portfolio") {
+                auto formula = Formula::load(filename);
+
+                auto start = chrono::high_resolution_clock::now();
+                cout << "Parser initialized successfully" << endl;
+                cout << "Formula statistics:" << endl;
+                cout << "Variables: " << formula->getNumLiterals() << endl;
+                cout << "Clauses: " << formula->getNumClauses() << endl;
+
+                // The solvers' own progress lines would interleave
+                streambuf* console = cout.rdbuf(nullptr);
+                ThreadPortfolioResult result = runThreadPortfolio(formula, 0);
+                cout.rdbuf(console);
+                cout.clear();
+
+                auto end = chrono::high_resolution_clock::now();
+                auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+
+                satlog::flush();
+                if (result.status == SolveResult::Unknown) {
+                    cout << "Final result: Unknown, the solvers stopped without an answer." << endl;
+                } else {
+                    cout << "Final result: The formula is "
+                         << (result.status == SolveResult::Sat ? "SATISFIABLE." : "UNSATISFIABLE.") << endl;
+                    cout << "Answered by solver " << result.winner << ": "
+                         << portfolioEntry(result.winner, *formula).describe() << endl;
+                }
+
+                cout << "Solving time: " << duration.count() << "ms" << endl;
+            } else if (solver_type == "pdpll") {
+                auto formula = Formula::load(filename);
+
+                auto start = chrono::high_resolution_clock::now();
+                cout << "Parser initialized successfully" << endl;
+                cout << "Formula statistics:" << endl;
+                cout << "Variables: " << formula->getNumLiterals() << endl;
+                cout << "Clauses: " << formula->getNumClauses() << endl;
+
+                ParallelDPLLResult result = runParallelDPLL(formula, 0);
+
+                auto end = chrono::high_resolution_clock::now();
+                auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+
+                satlog::flush();
+                if (result.status == SolveResult::Unknown) {
+                    cout << "Final result: Unknown, the search stopped without an answer." << endl;
+                } else {
+                    cout << "Final result: The formula is "
+                         << (result.status == SolveResult::Sat ? "SATISFIABLE." : "UNSATISFIABLE.") << endl;
+                }
+                cout << "Subtrees searched: " << result.subtrees << ", branches stolen: " << result.steals << endl;
+
                 cout << "Solving time: " << duration.count() << "ms" << endl;
             }
 
@@ -0,0 +1,188 @@
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <mpi.h>
+#include "include/general/log.h"
+#include "include/mpi/mpiformula.h"
+#include "include/mpi/portfolio.h"
+#include "include/mpi/cubeandconquer.h"
+
+using namespace std;
+
+// Distributed front end:
+//
+//   mpirun -np N MPI_SAT_Distributed [options] <file>
+//
+// In portfolio mode (the default) every rank runs a different solver
+// configuration on the same formula (see mpi/portfolio.h); in cube mode
+// rank 0 splits the formula into cubes and the other ranks solve them
+// (see mpi/cubeandconquer.h). Rank 0 prints the first answer in SAT competition
+// format and exits with its code (10 SAT, 20 UNSAT, 0 unknown), which
+// mpirun passes on; the other ranks exit with 0.
+
+namespace {
+
+// Swallows the progress output the solvers write to cout
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+void printUsage(ostream& out) {
+    out << "Usage: mpirun -np N MPI_SAT_Distributed [options] <file>\n"
+           "\n"
+           "Options:\n"
+           "  -m, --mode NAME      portfolio or cube (default portfolio)\n"
+           "  -t, --timeout SEC    time limit in seconds (default none)\n"
+           "Portfolio mode:\n"
+           "  -S, --share SEC      learnt clause exchange every SEC seconds, 0 for none (default 0.5)\n"
+           "Cube mode:\n"
+           "  -e, --engine NAME    dpll or cdcl, solves the cubes (default dpll)\n"
+           "  -d, --depth N        decisions per initial cube (default from the rank count)\n"
+           "  -s, --split SEC      run time before a cube may be split for idle ranks (default 0.5)\n"
+           "\n"
+           "  -l, --log LEVEL      none, error, info, debug or trace (log goes to stderr)\n"
+           "  -n, --no-model       leave out the v lines\n"
+           "  -h, --help           show this help\n";
+}
+
+void printModel(ostream& out, vector<int> model) {
+    sort(model.begin(), model.end(), [](int a, int b) { return abs(a) < abs(b); });
+    string line = "v";
+    for (int lit : model) {
+        string token = " " + to_string(lit);
+        if (line.size() + token.size() > 78) {
+            out << line << "\n";
+            line = "v";
+        }
+        line += token;
+    }
+    out << line << " 0\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    string file;
+    string mode = "portfolio";
+    CubeOptions cubeOptions;
+    double timeout = 0;
+    double shareInterval = 0.5;
+    bool printModelLines = true;
+    bool usageError = false;
+    for (int i = 1; i < argc && !usageError; i++) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            if (rank == 0) printUsage(cout);
+            MPI_Finalize();
+            return 0;
+        } else if ((arg == "-m" || arg == "--mode") && i + 1 < argc) {
+            mode = argv[++i];
+            usageError = mode != "portfolio" && mode != "cube";
+        } else if ((arg == "-t" || arg == "--timeout") && i + 1 < argc) {
+            istringstream in(argv[++i]);
+            usageError = !(in >> timeout) || timeout < 0;
+        } else if ((arg == "-S" || arg == "--share") && i + 1 < argc) {
+            istringstream in(argv[++i]);
+            usageError = !(in >> shareInterval) || shareInterval < 0;
+        } else if ((arg == "-e" || arg == "--engine") && i + 1 < argc) {
+            cubeOptions.engine = argv[++i];
+            usageError = cubeOptions.engine != "dpll" && cubeOptions.engine != "cdcl";
+        } else if ((arg == "-d" || arg == "--depth") && i + 1 < argc) {
+            istringstream in(argv[++i]);
+            usageError = !(in >> cubeOptions.depth) || cubeOptions.depth < 0;
+        } else if ((arg == "-s" || arg == "--split") && i + 1 < argc) {
+            istringstream in(argv[++i]);
+            usageError = !(in >> cubeOptions.splitAfter) || cubeOptions.splitAfter < 0;
+        } else if ((arg == "-l" || arg == "--log") && i + 1 < argc) {
+            int level = satlog::parseLevel(argv[++i]);
+            usageError = level < 0;
+            if (!usageError) satlog::setLevel(level);
+        } else if (arg == "-n" || arg == "--no-model") {
+            printModelLines = false;
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            usageError = true;
+        } else if (file.empty()) {
+            file = arg;
+        } else {
+            usageError = true;
+        }
+    }
+    if (usageError || file.empty()) {
+        if (rank == 0) printUsage(cerr);
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Results own stdout; log lines go to stderr
+    satlog::setOutput(stderr);
+    NullBuffer null;
+    streambuf* console = cout.rdbuf(&null);
+
+    int exitCode = 0;
+    try {
+        auto start = chrono::steady_clock::now();
+        auto formula = broadcastFormula(file, MPI_COMM_WORLD);
+        SolveResult status = SolveResult::Unknown;
+        int winner = -1;
+        vector<int> model;
+        string summary;
+        if (mode == "cube") {
+            cubeOptions.timeout = timeout;
+            CubeResult result = runCubeAndConquer(formula, cubeOptions, MPI_COMM_WORLD);
+            status = result.status;
+            winner = result.winner;
+            model = move(result.model);
+            summary = "cube and conquer (" + cubeOptions.engine + ") on " + to_string(size) + " ranks, " +
+                      to_string(result.cubes) + " cubes refuted, " + to_string(result.splits) + " split";
+        } else {
+            PortfolioResult result = runPortfolio(formula, timeout, MPI_COMM_WORLD, shareInterval);
+            status = result.status;
+            winner = result.winner;
+            model = move(result.model);
+            summary = "portfolio of " + to_string(size) + " ranks";
+            if (shareInterval > 0 && size > 1) {
+                summary += ", " + to_string(result.exported) + " clauses shared, " + to_string(result.imported) +
+                           " imported";
+            }
+            if (winner >= 0) summary += ", answered by rank " + to_string(winner) + " (" +
+                                        portfolioEntry(winner, *formula).describe() + ")";
+        }
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+        satlog::flush();
+
+        if (rank == 0) {
+            exitCode = static_cast<int>(status);
+            cout.rdbuf(console);
+            cout << "c " << file << "\n";
+            cout << "c " << elapsed << " ms, " << formula->getNumVars() << " variables, "
+                 << formula->getNumParsedClauses() << " clauses\n";
+            cout << "c " << summary << "\n";
+            if (status == SolveResult::Sat) {
+                cout << "s SATISFIABLE\n";
+                if (printModelLines) printModel(cout, model);
+            } else if (status == SolveResult::Unsat) {
+                cout << "s UNSATISFIABLE\n";
+            } else {
+                cout << "s UNKNOWN\n";
+            }
+            cout.flush();
+        }
+    } catch (const exception& e) {
+        // Only broadcastFormula() throws, and on every rank alike
+        if (rank == 0) cerr << "Error: " << e.what() << "\n";
+        exitCode = 1;
+    }
+    cout.rdbuf(console);
+
+    MPI_Finalize();
+    return exitCode;
+}